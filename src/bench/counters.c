@@ -0,0 +1,77 @@
+// qsort and memcpy with hardware counters
+// qsort of sorted, reversed and random int arrays of a cache resident
+// and a larger size (an iteration copies the input and sorts it) and
+// memcpy from l1 to beyond the last level cache sizes, the ipc and the
+// cache, branch and tlb misses per call show where a slowdown comes from
+// (the counters are left out where perf_event_open is not available)
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "test.h"
+
+#define NMAX (1<<18)
+
+static int in[NMAX], work[NMAX];
+static char *src, *dst;
+
+static int cmp(const void *a, const void *b)
+{
+	int x = *(const int *)a, y = *(const int *)b;
+
+	return x < y ? -1 : x > y;
+}
+
+static void run_qsort(void *p, long n)
+{
+	size_t len = *(size_t *)p;
+
+	while (n--) {
+		memcpy(work, in, len * sizeof *in);
+		qsort(work, len, sizeof *work, cmp);
+	}
+}
+
+static void run_memcpy(void *p, long n)
+{
+	size_t len = *(size_t *)p;
+
+	while (n--)
+		memcpy(dst, src, len);
+}
+
+int main(void)
+{
+	static const char *order[] = {"sorted", "reversed", "random"};
+	static const size_t nsort[] = {1024, NMAX};
+	static const size_t ncopy[] = {64, 4096, 1<<16, 1<<20, 1<<25};
+	struct t_bench b;
+	char name[64];
+	size_t i, j, k, len;
+
+	for (i = 0; i < sizeof nsort / sizeof *nsort; i++)
+		for (j = 0; j < sizeof order / sizeof *order; j++) {
+			len = nsort[i];
+			t_randseed(1);
+			for (k = 0; k < len; k++)
+				in[k] = j == 0 ? k : j == 1 ? len - k : (int)t_randn(len);
+			snprintf(name, sizeof name, "qsort %s %zu", order[j], len);
+			if (t_bench(&b, name, run_qsort, &len) == 0)
+				t_benchprint(name, &b);
+		}
+
+	src = malloc(ncopy[sizeof ncopy / sizeof *ncopy - 1]);
+	dst = malloc(ncopy[sizeof ncopy / sizeof *ncopy - 1]);
+	if (!src || !dst) {
+		t_error("malloc failed\n");
+		return t_status;
+	}
+	memset(src, 1, ncopy[sizeof ncopy / sizeof *ncopy - 1]);
+	memset(dst, 2, ncopy[sizeof ncopy / sizeof *ncopy - 1]);
+	for (i = 0; i < sizeof ncopy / sizeof *ncopy; i++) {
+		len = ncopy[i];
+		snprintf(name, sizeof name, "memcpy %zu", len);
+		if (t_bench(&b, name, run_memcpy, &len) == 0)
+			t_benchprint(name, &b);
+	}
+	return t_status;
+}
@@ -0,0 +1,105 @@
+// crypt cost per hash scheme and rounds parameter
+// hashes/s for des, md5, bcrypt and sha-crypt at a range of cost
+// settings, it is checked that the cost is linear in the number of
+// rounds (2^cost for bcrypt) and that the memory use does not grow
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <crypt.h>
+#include <sys/resource.h>
+#include "test.h"
+
+#define MAXRSS 1024
+
+static const char key[] = "correct horse battery staple";
+
+static struct {
+	char *name;
+	char *fmt;
+	long rounds[4];
+} scheme[] = {
+	{"des", "ab", {1}},
+	{"md5", "$1$saltsalt$", {1}},
+	{"bcrypt", "$2b$%02ld$abcdefghijklmnopqrstuu", {4, 6, 8, 10}},
+	{"sha256", "$5$rounds=%ld$saltstringsaltst$", {1000, 4000, 16000, 64000}},
+	{"sha512", "$6$rounds=%ld$saltstringsaltst$", {1000, 4000, 16000, 64000}},
+};
+
+static void run(void *setting, long n)
+{
+	while (n--)
+		crypt(key, setting);
+}
+
+static long maxrss(void)
+{
+	struct rusage ru;
+
+	if (getrusage(RUSAGE_SELF, &ru))
+		return 0;
+	return ru.ru_maxrss;
+}
+
+/* seconds per hash, -1 if the setting is not supported */
+static double measure(const char *setting)
+{
+	struct t_bench b;
+	char hash[128], name[96];
+	char *p;
+
+	p = crypt(key, setting);
+	if (!p || *p == '*')
+		return -1;
+	snprintf(hash, sizeof hash, "%s", p);
+	p = crypt(key, hash);
+	if (!p || strcmp(p, hash)) {
+		t_error("crypt(key, \"%s\") = \"%s\", want \"%s\"\n", hash, p ? p : "(null)", hash);
+		return -1;
+	}
+	snprintf(name, sizeof name, "crypt %s", setting);
+	if (t_bench(&b, name, run, (void *)setting) < 0)
+		return -1;
+	return b.med;
+}
+
+int main(void)
+{
+	char setting[64];
+	double t[4];
+	long r[4], rss0, rss;
+	size_t i;
+	int j, n;
+
+	for (i = 0; i < sizeof scheme/sizeof *scheme; i++) {
+		rss0 = maxrss();
+		for (n = 0; n < 4 && scheme[i].rounds[n]; n++) {
+			snprintf(setting, sizeof setting, scheme[i].fmt, scheme[i].rounds[n]);
+			t[n] = measure(setting);
+			if (t[n] < 0) {
+				printf("%-6s %-36s n/a\n", scheme[i].name, setting);
+				break;
+			}
+			/* bcrypt does 2^cost rounds */
+			r[n] = scheme[i].fmt[1] == '2' ? 1L << scheme[i].rounds[n] : scheme[i].rounds[n];
+			printf("%-6s %-36s %10.1f hashes/s", scheme[i].name, setting, 1/t[n]);
+			if (n)
+				printf(" %8.1f ns/round", (t[n]-t[0]) / (r[n]-r[0]) * 1e9);
+			printf("\n");
+		}
+		rss = maxrss() - rss0;
+		printf("%-6s max rss growth %ld KB\n", scheme[i].name, rss);
+		if (rss > MAXRSS)
+			t_error("%s: max rss grew by %ld KB\n", scheme[i].name, rss);
+
+		/* check that the intermediate settings fit the line through the extremes */
+		if (n < 3)
+			continue;
+		for (j = 1; j < n-1; j++) {
+			double want = t[0] + (t[n-1]-t[0]) * (r[j]-r[0]) / (r[n-1]-r[0]);
+			if (t[j] > 2*want || t[j] < want/2)
+				t_error("%s: cost is not linear in rounds: %ld rounds took %.3g s, want %.3g s\n",
+					scheme[i].name, r[j], t[j], want);
+		}
+	}
+	return t_status;
+}
@@ -0,0 +1,310 @@
+// sysv and posix ipc round trip latency between two processes
+// ping-pong over msgsnd/msgrcv, semop, process-shared sem_post/sem_wait
+// and process-shared mutex+condvar in sysv shared memory, the payload
+// is copied through the message or the shared memory buffer. round trip
+// latency percentiles and messages/s (both directions, from the median)
+// are reported per payload size.
+#ifndef _XOPEN_SOURCE
+#define _XOPEN_SOURCE 700
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <sys/types.h>
+#include <sys/ipc.h>
+#include <sys/msg.h>
+#include <sys/sem.h>
+#include <sys/shm.h>
+#include <sys/wait.h>
+#include "test.h"
+
+#define T(f) ((f)+1 == 0 ? (t_error("%s failed: %s\n", #f, strerror(errno)), -1) : 0)
+#define T2(f) ((r = (f)) ? (t_error("%s failed: %s\n", #f, strerror(r)), -1) : 0)
+
+#define MAXMSG 4096
+
+static struct shared {
+	pthread_mutex_t m;
+	pthread_cond_t c;
+	int turn;
+	volatile long last;  /* pongs the child answers, 0 until known */
+	sem_t s[2];
+	char buf[MAXMSG];
+} *sh;
+
+static struct {
+	long type;
+	char data[MAXMSG];
+} msg;
+
+static int qid = -1;
+static int semid = -1;
+static char payload[MAXMSG];
+static char got[MAXMSG];
+
+static int msg_init(void)
+{
+	return T(qid = msgget(IPC_PRIVATE, IPC_CREAT|0600));
+}
+
+static void msg_fini(void)
+{
+	T(msgctl(qid, IPC_RMID, 0));
+}
+
+static int msg_ping(size_t n)
+{
+	msg.type = 1;
+	memcpy(msg.data, payload, n);
+	if (T(msgsnd(qid, &msg, n, 0)) || T(msgrcv(qid, &msg, MAXMSG, 2, 0)))
+		return -1;
+	memcpy(got, msg.data, n);
+	return 0;
+}
+
+static int msg_pong(size_t n)
+{
+	if (T(msgrcv(qid, &msg, MAXMSG, 1, 0)))
+		return -1;
+	msg.type = 2;
+	return T(msgsnd(qid, &msg, n, 0));
+}
+
+static int semop_init(void)
+{
+	union semun {
+		int val;
+		struct semid_ds *buf;
+		unsigned short *array;
+	} arg = {.array = (unsigned short[]){0, 0}};
+
+	if (T(semid = semget(IPC_PRIVATE, 2, IPC_CREAT|0600)))
+		return -1;
+	return T(semctl(semid, 0, SETALL, arg));
+}
+
+static void semop_fini(void)
+{
+	T(semctl(semid, 0, IPC_RMID));
+}
+
+static int semop1(int i, int op)
+{
+	struct sembuf sops = {.sem_num = i, .sem_op = op, .sem_flg = 0};
+
+	return T(semop(semid, &sops, 1));
+}
+
+static int semop_ping(size_t n)
+{
+	memcpy(sh->buf, payload, n);
+	if (semop1(0, 1) || semop1(1, -1))
+		return -1;
+	memcpy(got, sh->buf, n);
+	return 0;
+}
+
+static int semop_pong(size_t n)
+{
+	if (semop1(0, -1))
+		return -1;
+	memcpy(got, sh->buf, n);
+	memcpy(sh->buf, got, n);
+	return semop1(1, 1);
+}
+
+static int sem_init2(void)
+{
+	if (T(sem_init(sh->s, 1, 0)))
+		return -1;
+	if (T(sem_init(sh->s+1, 1, 0))) {
+		sem_destroy(sh->s);
+		return -1;
+	}
+	return 0;
+}
+
+static void sem_fini(void)
+{
+	sem_destroy(sh->s);
+	sem_destroy(sh->s+1);
+}
+
+static int sem_ping(size_t n)
+{
+	memcpy(sh->buf, payload, n);
+	if (T(sem_post(sh->s)) || T(sem_wait(sh->s+1)))
+		return -1;
+	memcpy(got, sh->buf, n);
+	return 0;
+}
+
+static int sem_pong(size_t n)
+{
+	if (T(sem_wait(sh->s)))
+		return -1;
+	memcpy(got, sh->buf, n);
+	memcpy(sh->buf, got, n);
+	return T(sem_post(sh->s+1));
+}
+
+static int cond_init(void)
+{
+	pthread_mutexattr_t ma;
+	pthread_condattr_t ca;
+	int r;
+
+	if (T2(pthread_mutexattr_init(&ma)) ||
+	    T2(pthread_mutexattr_setpshared(&ma, PTHREAD_PROCESS_SHARED)) ||
+	    T2(pthread_mutex_init(&sh->m, &ma)))
+		return -1;
+	pthread_mutexattr_destroy(&ma);
+	if (T2(pthread_condattr_init(&ca)) ||
+	    T2(pthread_condattr_setpshared(&ca, PTHREAD_PROCESS_SHARED)) ||
+	    T2(pthread_cond_init(&sh->c, &ca))) {
+		pthread_mutex_destroy(&sh->m);
+		return -1;
+	}
+	pthread_condattr_destroy(&ca);
+	sh->turn = 0;
+	return 0;
+}
+
+static void cond_fini(void)
+{
+	pthread_cond_destroy(&sh->c);
+	pthread_mutex_destroy(&sh->m);
+}
+
+static int cond_ping(size_t n)
+{
+	pthread_mutex_lock(&sh->m);
+	memcpy(sh->buf, payload, n);
+	sh->turn = 1;
+	pthread_cond_broadcast(&sh->c);
+	while (sh->turn != 0)
+		pthread_cond_wait(&sh->c, &sh->m);
+	memcpy(got, sh->buf, n);
+	pthread_mutex_unlock(&sh->m);
+	return 0;
+}
+
+static int cond_pong(size_t n)
+{
+	pthread_mutex_lock(&sh->m);
+	while (sh->turn != 1)
+		pthread_cond_wait(&sh->c, &sh->m);
+	memcpy(got, sh->buf, n);
+	memcpy(sh->buf, got, n);
+	sh->turn = 0;
+	pthread_cond_broadcast(&sh->c);
+	pthread_mutex_unlock(&sh->m);
+	return 0;
+}
+
+static struct {
+	char *name;
+	int (*init)(void);
+	void (*fini)(void);
+	int (*ping)(size_t);
+	int (*pong)(size_t);
+} mech[] = {
+	{"msgsnd/msgrcv", msg_init, msg_fini, msg_ping, msg_pong},
+	{"semop", semop_init, semop_fini, semop_ping, semop_pong},
+	{"sem_post/wait", sem_init2, sem_fini, sem_ping, sem_pong},
+	{"mutex/cond", cond_init, cond_fini, cond_ping, cond_pong},
+};
+
+struct ping {
+	int i;
+	size_t n;
+	int err;
+	long count;
+};
+
+static void ping(void *p)
+{
+	struct ping *a = p;
+
+	if (!a->err)
+		a->err = mech[a->i].ping(a->n);
+	a->count++;
+}
+
+static void bench(int i, size_t n)
+{
+	struct ping a = {i, n, 0, 0};
+	struct t_bench b;
+	char name[64];
+	pid_t pid;
+	long k;
+	int status;
+
+	if (mech[i].init())
+		return;
+	/* the child answers until the last ping, the count of which is set
+	after the benchmark when the child is already waiting for it */
+	sh->last = 0;
+	pid = fork();
+	if (pid == 0) {
+		for (k = 1; ; k++)
+			if (mech[i].pong(n))
+				_exit(1);
+			else if (k == sh->last)
+				_exit(0);
+	}
+	if (pid == -1) {
+		t_error("fork failed: %s\n", strerror(errno));
+		mech[i].fini();
+		return;
+	}
+	snprintf(name, sizeof name, "ipc %s %zu", mech[i].name, n);
+	if (t_benchlat(&b, name, 0, ping, &a) == 0 && !a.err) {
+		if (memcmp(got, payload, n))
+			t_error("%s: payload of size %zu is corrupted\n", mech[i].name, n);
+		printf("%-13s %4zu bytes p50 %7.2f us p90 %7.2f us p99 %7.2f us max %8.2f us %9.0f msgs/s\n",
+			mech[i].name, n, b.med*1e6, b.p90*1e6, b.p99*1e6, b.max*1e6, 2/b.med);
+	}
+	/* after an error the child may wait for a ping forever (removing the
+	objects only wakes it for sysv ipc), so it is killed */
+	if (!a.err) {
+		sh->last = a.count + 1;
+		ping(&a);
+	}
+	if (a.err)
+		kill(pid, SIGKILL);
+	if (waitpid(pid, &status, 0) != pid)
+		t_error("waitpid failed: %s\n", strerror(errno));
+	else if (!a.err && (!WIFEXITED(status) || WEXITSTATUS(status)))
+		t_error("%s: child failed with status 0x%x\n", mech[i].name, status);
+	mech[i].fini();
+}
+
+int main(void)
+{
+	static const size_t size[] = {8, 64, 512, 4096};
+	size_t i, j;
+	int shmid;
+
+	for (i = 0; i < MAXMSG; i++)
+		payload[i] = i;
+	if (T(shmid = shmget(IPC_PRIVATE, sizeof *sh, IPC_CREAT|0600)))
+		return t_status;
+	sh = shmat(shmid, 0, 0);
+	/* the segment is destroyed when both processes detached */
+	T(shmctl(shmid, IPC_RMID, 0));
+	if (sh == (void *)-1) {
+		t_error("shmat failed: %s\n", strerror(errno));
+		return t_status;
+	}
+	for (i = 0; i < sizeof mech/sizeof *mech; i++)
+		for (j = 0; j < sizeof size/sizeof *size; j++)
+			bench(i, size[j]);
+	shmdt(sh);
+	return t_status;
+}
@@ -0,0 +1,189 @@
+// multibyte/wide character conversion throughput
+// per-character calls (mbrtowc, wcrtomb) are compared with the bulk
+// interfaces (mbstowcs, mbsrtowcs, wcstombs) on different utf-8 corpora
+// in the C and in a UTF-8 locale, the per-char/bulk ratio on the ascii
+// corpus shows how much an ascii fast path in the bulk functions gains
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <locale.h>
+#include <wchar.h>
+#include "test.h"
+
+#define LEN (1<<16)
+
+static struct {
+	char *name;
+	char *s;
+} corpus[] = {
+	{"ascii", "The quick brown fox jumps over the lazy dog. 0123456789\n"},
+	{"latin", "Zwölf Boxkämpfer jagen Viktor quer über den großen Sylter Deich. "
+		"Árvíztűrő tükörfúrógép, façade, naïveté, smørrebrød.\n"},
+	{"cjk", "\xe6\x97\xa5\xe6\x9c\xac\xe8\xaa\x9e\xe3\x81\xae\xe6\x96\x87\xe7"
+		"\xab\xa0\xe3\x81\xa8\xe4\xb8\xad\xe6\x96\x87\xe7\x9a\x84\xe5\x8f"
+		"\xa5\xe5\xad\x90\xe3\x80\x82\xed\x95\x9c\xea\xb5\xad\xec\x96\xb4\n"},
+	{"emoji", "\xf0\x9f\x98\x80\xf0\x9f\x98\x82\xf0\x9f\x91\x8d\xf0\x9f\x8e\x89"
+		"\xf0\x9f\x9a\x80 ok \xf0\x9f\x90\xb1\xf0\x9f\x8c\x8d\xf0\x9f\x92\xa9\n"},
+};
+
+static char src[LEN+1];
+static char dst[4*LEN+1];
+static wchar_t wsrc[LEN+1];
+static wchar_t wdst[LEN+1];
+static size_t srclen;
+static size_t wsrclen;
+
+/* fill src with copies of s, cut at a character boundary */
+static void fill(const char *s)
+{
+	size_t n = strlen(s);
+
+	for (srclen = 0; srclen + n <= LEN; srclen += n)
+		memcpy(src + srclen, s, n);
+	src[srclen] = 0;
+}
+
+/* each conversion returns -1 if it failed on the corpus */
+static long run_mbrtowc(void)
+{
+	mbstate_t st = {0};
+	wchar_t wc;
+	size_t i, r;
+	long n = 0;
+
+	for (i = 0; i < srclen; i += r, n++) {
+		r = mbrtowc(&wc, src + i, srclen - i, &st);
+		if (r == (size_t)-1 || r == (size_t)-2)
+			return -1;
+		if (r == 0)
+			r = 1;
+	}
+	return n;
+}
+
+static long run_mbstowcs(void)
+{
+	return mbstowcs(wdst, src, LEN+1);
+}
+
+/* convert in small chunks like a streaming decoder would */
+static long run_mbsrtowcs(void)
+{
+	mbstate_t st = {0};
+	const char *p = src;
+	size_t r;
+	long n = 0;
+
+	while (p) {
+		r = mbsrtowcs(wdst, &p, 64, &st);
+		if (r == (size_t)-1)
+			return -1;
+		n += r;
+	}
+	return n;
+}
+
+static long run_wcrtomb(void)
+{
+	mbstate_t st = {0};
+	size_t i, r;
+	char *p = dst;
+
+	for (i = 0; i < wsrclen; i++) {
+		r = wcrtomb(p, wsrc[i], &st);
+		if (r == (size_t)-1)
+			return -1;
+		p += r;
+	}
+	return p - dst;
+}
+
+static long run_wcstombs(void)
+{
+	return wcstombs(dst, wsrc, sizeof dst);
+}
+
+static struct func {
+	char *name;
+	long (*f)(void);
+} func[] = {
+	{"mbrtowc", run_mbrtowc},
+	{"mbstowcs", run_mbstowcs},
+	{"mbsrtowcs", run_mbsrtowcs},
+	{"wcrtomb", run_wcrtomb},
+	{"wcstombs", run_wcstombs},
+};
+
+static void run(void *p, long n)
+{
+	struct func *fn = p;
+
+	while (n--)
+		fn->f();
+}
+
+/* returns utf-8 bytes/s or 0 if the conversion fails in this locale */
+static double measure(struct func *fn, const char *loc, const char *corp)
+{
+	struct t_bench b;
+	char name[64];
+
+	if (fn->f() == -1)
+		return 0;
+	snprintf(name, sizeof name, "mbconv %s %s %s", loc, corp, fn->name);
+	if (t_bench(&b, name, run, fn) < 0)
+		return 0;
+	return srclen / b.med;
+}
+
+static void bench(const char *name, const char *loc)
+{
+	double r[sizeof func/sizeof *func];
+	size_t i, j;
+
+	for (i = 0; i < sizeof corpus/sizeof *corpus; i++) {
+		/* the wide corpus is the utf-8 decoding of the byte corpus */
+		fill(corpus[i].s);
+		if (!t_setutf8())
+			wsrclen = mbstowcs(wsrc, src, LEN+1);
+		else
+			wsrclen = 0;
+		if (!setlocale(LC_CTYPE, loc)) {
+			t_error("setlocale(LC_CTYPE, \"%s\") failed\n", loc);
+			return;
+		}
+		if (wsrclen == (size_t)-1) {
+			t_error("mbstowcs failed on %s corpus: %s\n", corpus[i].name, strerror(errno));
+			continue;
+		}
+		printf("%-5s %-6s", name, corpus[i].name);
+		for (j = 0; j < sizeof func/sizeof *func; j++) {
+			r[j] = measure(func + j, name, corpus[i].name);
+			if (r[j])
+				printf(" %s %8.1f MB/s", func[j].name, r[j]*1e-6);
+			else
+				printf(" %s      n/a     ", func[j].name);
+		}
+		if (r[0] && r[1])
+			printf(" mbstowcs/mbrtowc %.2f", r[1]/r[0]);
+		if (r[3] && r[4])
+			printf(" wcstombs/wcrtomb %.2f", r[4]/r[3]);
+		printf("\n");
+	}
+}
+
+int main(void)
+{
+	const char *utf8;
+
+	bench("C", "C");
+	if (t_setutf8())
+		return t_status;
+	utf8 = setlocale(LC_CTYPE, 0);
+	if (utf8)
+		utf8 = strdup(utf8);
+	if (utf8)
+		bench("utf8", utf8);
+	return t_status;
+}
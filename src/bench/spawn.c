@@ -0,0 +1,299 @@
+// process creation latency: fork, vfork, posix_spawn, popen, system
+// the parent touches more and more memory (1MB .. several GB, limited
+// by physical memory) and runs more and more idle threads, the median
+// latency from the call to the exec in the child (noticed via a close on
+// exec pipe) and to the exit of the child is reported. posix_spawn staying
+// flat while fork grows with rss shows a CLONE_VM/vfork based spawn.
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <spawn.h>
+#include <pthread.h>
+#include <sys/wait.h>
+#include "test.h"
+
+extern char **environ;
+
+static char *self;
+static char cmd[4096];
+static int execfd[2] = {-1, -1};
+
+/* the child of the last call, reaped in the setup of the next one */
+static struct spawn {
+	int prim;
+	int exit;     /* measure until the exit, not the exec */
+	int err;
+	pid_t pid;
+	FILE *f;
+} sp;
+
+/* the write end is closed by the exec in the child */
+static int openexecfd(void)
+{
+	if (pipe(execfd)) {
+		t_error("pipe failed: %s\n", strerror(errno));
+		return -1;
+	}
+	fcntl(execfd[0], F_SETFD, FD_CLOEXEC);
+	fcntl(execfd[1], F_SETFD, FD_CLOEXEC);
+	return 0;
+}
+
+static void closeexecfd(void)
+{
+	if (execfd[0] >= 0)
+		close(execfd[0]);
+	if (execfd[1] >= 0)
+		close(execfd[1]);
+	execfd[0] = execfd[1] = -1;
+}
+
+static void waitexec(void)
+{
+	char c;
+
+	close(execfd[1]);
+	execfd[1] = -1;
+	while (read(execfd[0], &c, 1) == -1 && errno == EINTR);
+}
+
+static int waitexit(pid_t pid)
+{
+	int status;
+
+	if (waitpid(pid, &status, 0) != pid) {
+		t_error("waitpid failed: %s\n", strerror(errno));
+		return -1;
+	}
+	if (!WIFEXITED(status) || WEXITSTATUS(status)) {
+		t_error("child failed: status 0x%x\n", status);
+		return -1;
+	}
+	return 0;
+}
+
+/* each primitive starts the child, the process or the popen stream is left in sp */
+static int run_fork(void)
+{
+	pid_t pid = fork();
+
+	if (pid == 0) {
+		execv(self, (char *[]){self, "-x", 0});
+		_exit(127);
+	}
+	if (pid == -1) {
+		t_error("fork failed: %s\n", strerror(errno));
+		return -1;
+	}
+	sp.pid = pid;
+	return 0;
+}
+
+static int run_vfork(void)
+{
+	pid_t pid = vfork();
+
+	if (pid == 0) {
+		execv(self, (char *[]){self, "-x", 0});
+		_exit(127);
+	}
+	if (pid == -1) {
+		t_error("vfork failed: %s\n", strerror(errno));
+		return -1;
+	}
+	sp.pid = pid;
+	return 0;
+}
+
+static int run_posix_spawn(void)
+{
+	pid_t pid;
+	int r;
+
+	r = posix_spawn(&pid, self, 0, 0, (char *[]){self, "-x", 0}, environ);
+	if (r) {
+		t_error("posix_spawn failed: %s\n", strerror(r));
+		return -1;
+	}
+	sp.pid = pid;
+	return 0;
+}
+
+/* popen and system exec the shell first, that is what the exec time sees */
+static int run_popen(void)
+{
+	sp.f = popen(cmd, "r");
+	if (!sp.f) {
+		t_error("popen failed: %s\n", strerror(errno));
+		return -1;
+	}
+	return 0;
+}
+
+/* returns after the exit, so only that is measured */
+static int run_system(void)
+{
+	int status;
+
+	status = system(cmd);
+	if (status) {
+		t_error("system failed: status 0x%x\n", status);
+		return -1;
+	}
+	return 0;
+}
+
+static struct {
+	char *name;
+	int (*f)(void);
+	int exec;     /* the exec can be noticed before the exit */
+} prim[] = {
+	{"fork", run_fork, 1},
+	{"vfork", run_vfork, 1},
+	{"posix_spawn", run_posix_spawn, 1},
+	{"popen", run_popen, 1},
+	{"system", run_system, 0},
+};
+
+static int reap(void)
+{
+	int r = 0, status;
+
+	if (sp.pid > 0)
+		r = waitexit(sp.pid);
+	if (sp.f && (status = pclose(sp.f))) {
+		t_error("pclose failed: status 0x%x\n", status);
+		r = -1;
+	}
+	sp.pid = 0;
+	sp.f = 0;
+	closeexecfd();
+	return r;
+}
+
+static void setup(void *p)
+{
+	if (reap() || openexecfd())
+		sp.err = 1;
+}
+
+static void run(void *p)
+{
+	if (sp.err || prim[sp.prim].f()) {
+		sp.err = 1;
+		return;
+	}
+	if (prim[sp.prim].exec)
+		waitexec();
+	if (sp.exit && reap())
+		sp.err = 1;
+}
+
+/* median seconds from the call to the exec or the exit of the child, -1 if failed */
+static double measure(int i, int exit, size_t mb, int nthread)
+{
+	struct t_bench b;
+	char name[64];
+	int r;
+
+	snprintf(name, sizeof name, "spawn %s %zuMB %dthr %s", prim[i].name, mb, nthread, exit ? "exit" : "exec");
+	sp = (struct spawn){.prim = i, .exit = exit};
+	r = t_benchlat(&b, name, setup, run, 0);
+	if (reap())
+		sp.err = 1;
+	return r < 0 || sp.err ? -1 : b.med;
+}
+
+static void bench(int i, size_t mb, int nthread)
+{
+	double texec = -1, texit;
+
+	if (prim[i].exec && (texec = measure(i, 0, mb, nthread)) < 0)
+		return;
+	if ((texit = measure(i, 1, mb, nthread)) < 0)
+		return;
+	printf("%-11s rss %5zu MB %3d threads", prim[i].name, mb, nthread);
+	if (texec >= 0)
+		printf(" exec %9.1f us", texec*1e6);
+	else
+		printf(" exec       n/a   ");
+	printf(" exit %9.1f us\n", texit*1e6);
+}
+
+static int idlefd[2];
+
+static void *idle(void *arg)
+{
+	char c;
+
+	while (read(idlefd[0], &c, 1) == -1 && errno == EINTR);
+	return 0;
+}
+
+static void benchall(size_t mb, int nthread)
+{
+	pthread_t td[64];
+	size_t i;
+	int j, r;
+
+	if (pipe(idlefd)) {
+		t_error("pipe failed: %s\n", strerror(errno));
+		return;
+	}
+	for (j = 0; j < nthread; j++)
+		if ((r = pthread_create(td + j, 0, idle, 0))) {
+			t_error("pthread_create failed: %s\n", strerror(r));
+			break;
+		}
+	nthread = j;
+	for (i = 0; i < sizeof prim/sizeof *prim; i++)
+		bench(i, mb, nthread);
+	close(idlefd[1]);
+	for (j = 0; j < nthread; j++)
+		pthread_join(td[j], 0);
+	close(idlefd[0]);
+}
+
+int main(int argc, char *argv[])
+{
+	static const size_t rss[] = {1, 16, 256, 1024, 4096};
+	static const int threads[] = {8, 64};
+	size_t i, j, mb, total, maxmb;
+	long pages, pagesz;
+	char *p = 0;
+
+	if (argc > 1 && strcmp(argv[1], "-x") == 0)
+		_exit(0);
+	self = argv[0];
+	if (snprintf(cmd, sizeof cmd, "%s -x", self) >= sizeof cmd) {
+		t_error("path too long: %s\n", self);
+		return t_status;
+	}
+
+	/* do not use more than half of the physical memory */
+	pages = sysconf(_SC_PHYS_PAGES);
+	pagesz = sysconf(_SC_PAGESIZE);
+	maxmb = pages > 0 && pagesz > 0 ? pages / 2 / (1024*1024 / pagesz) : 256;
+
+	for (i = total = 0; i < sizeof rss/sizeof *rss && rss[i] <= maxmb; i++) {
+		/* grow the touched memory of the parent to rss[i] MB */
+		mb = rss[i] - total;
+		p = malloc(mb << 20);
+		if (!p) {
+			t_error("malloc %zu MB failed\n", mb);
+			break;
+		}
+		for (j = 0; j < mb << 20; j += pagesz)
+			p[j] = 1;
+		total = rss[i];
+		benchall(total, 0);
+		if (i == 0)
+			for (j = 0; j < sizeof threads/sizeof *threads; j++)
+				benchall(total, threads[j]);
+	}
+	return t_status;
+}
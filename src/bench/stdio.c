@@ -0,0 +1,393 @@
+// stdio buffered i/o throughput and locking overhead
+// getc/getc_unlocked/fgets/getline/fread/fwrite/fputs on regular files,
+// pipes and memory streams in each buffering mode, both from one thread
+// and from several threads sharing the FILE. the read/write syscalls per
+// MB (from /proc/self/io) separate the copy cost from the syscall cost,
+// getc vs getc_unlocked and the threaded runs show the locking cost.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/wait.h>
+#include "test.h"
+
+#define N (1<<21)
+#define NNBF (1<<16)
+#define LINE 64
+#define NTHREAD 4
+
+enum {FILE_, PIPE, MEM};
+static char *kindname[] = {"file", "pipe", "mem"};
+
+static struct {
+	char *name;
+	int mode;
+	size_t size;
+} buffering[] = {
+	{"nbf", _IONBF, 0},
+	{"lbf", _IOLBF, BUFSIZ},
+	{"fbf", _IOFBF, 512},
+	{"fbf", _IOFBF, BUFSIZ},
+	{"fbf", _IOFBF, 1<<16},
+};
+
+static char data[N];
+static char path[] = "/tmp/libc-test-bench-stdio-XXXXXX";
+static char wpath[] = "/tmp/libc-test-bench-stdio-XXXXXX";
+static char vbuf[1<<16];
+
+/* read+write syscalls of the process so far, -1 if unknown */
+static long long syscalls(void)
+{
+	char buf[512], *p;
+	long long n = 0;
+	int fd, k;
+
+	fd = open("/proc/self/io", O_RDONLY);
+	if (fd < 0)
+		return -1;
+	k = read(fd, buf, sizeof buf - 1);
+	close(fd);
+	if (k <= 0)
+		return -1;
+	buf[k] = 0;
+	if (!(p = strstr(buf, "syscr:")))
+		return -1;
+	n += strtoll(p+6, 0, 10);
+	if (!(p = strstr(buf, "syscw:")))
+		return -1;
+	n += strtoll(p+6, 0, 10);
+	return n;
+}
+
+/* each op transfers at most n bytes and returns the bytes transferred */
+static size_t op_getc(FILE *f, size_t n)
+{
+	size_t i;
+
+	for (i = 0; i < n && getc(f) != EOF; i++);
+	return i;
+}
+
+/* explicit locking around batches so it is valid with shared FILEs too */
+static size_t op_getc_unlocked(FILE *f, size_t n)
+{
+	size_t i, j;
+	int c = 0;
+
+	for (i = 0; i < n && c != EOF;) {
+		flockfile(f);
+		for (j = 0; j < LINE && i < n && (c = getc_unlocked(f)) != EOF; j++, i++);
+		funlockfile(f);
+	}
+	return i;
+}
+
+static size_t op_fgets(FILE *f, size_t n)
+{
+	char buf[2*LINE];
+	size_t i;
+
+	for (i = 0; i < n && fgets(buf, sizeof buf, f); i += strlen(buf));
+	return i;
+}
+
+static size_t op_getline(FILE *f, size_t n)
+{
+	char *buf = 0;
+	size_t len = 0;
+	ssize_t k;
+	size_t i;
+
+	for (i = 0; i < n && (k = getline(&buf, &len, f)) > 0; i += k);
+	free(buf);
+	return i;
+}
+
+static size_t op_fread(FILE *f, size_t n)
+{
+	char buf[4096];
+	size_t i, k;
+
+	for (i = 0; i < n && (k = fread(buf, 1, sizeof buf, f)); i += k);
+	return i;
+}
+
+static size_t op_fwrite(FILE *f, size_t n)
+{
+	size_t i;
+
+	for (i = 0; i < n && fwrite(data, 1, LINE, f) == LINE; i += LINE);
+	return i;
+}
+
+static size_t op_fputs(FILE *f, size_t n)
+{
+	char line[LINE+1];
+	size_t i;
+
+	memcpy(line, data, LINE);
+	line[LINE] = 0;
+	for (i = 0; i < n && fputs(line, f) >= 0; i += LINE);
+	return i;
+}
+
+static struct {
+	char *name;
+	int write;
+	size_t (*f)(FILE *, size_t);
+} op[] = {
+	{"getc", 0, op_getc},
+	{"getc_unlocked", 0, op_getc_unlocked},
+	{"fgets", 0, op_fgets},
+	{"getline", 0, op_getline},
+	{"fread", 0, op_fread},
+	{"fwrite", 1, op_fwrite},
+	{"fputs", 1, op_fputs},
+};
+
+struct stream {
+	FILE *f;
+	pid_t pid;
+	char *mem;
+};
+
+/* the other end of a pipe is a child process so its syscalls are not counted */
+static pid_t child(int p[2], int wr)
+{
+	int fd = p[wr];
+	char buf[1<<16];
+	ssize_t k;
+	size_t i;
+	pid_t pid;
+
+	pid = fork();
+	if (pid)
+		return pid;
+	close(p[!wr]);
+	if (wr)
+		for (i = 0; i < N && (k = write(fd, data + i, N - i)) > 0; i += k);
+	else
+		while (read(fd, buf, sizeof buf) > 0);
+	_exit(0);
+}
+
+static int open_stream(struct stream *s, int kind, int wr)
+{
+	int p[2];
+
+	memset(s, 0, sizeof *s);
+	switch (kind) {
+	case FILE_:
+		s->f = wr ? fopen(wpath, "w") : fopen(path, "r");
+		break;
+	case PIPE:
+		if (pipe(p))
+			break;
+		s->pid = child(p, !wr);
+		close(p[!wr]);
+		if (s->pid == -1) {
+			close(p[wr]);
+			break;
+		}
+		s->f = fdopen(p[wr], wr ? "w" : "r");
+		break;
+	case MEM:
+		/* open_memstream is not used as it may not support setvbuf */
+		if (wr) {
+			s->mem = malloc(N+1);
+			if (s->mem)
+				s->f = fmemopen(s->mem, N+1, "w");
+		} else
+			s->f = fmemopen(data, N, "r");
+		break;
+	}
+	if (!s->f) {
+		t_error("cannot open %s stream: %s\n", kindname[kind], strerror(errno));
+		free(s->mem);
+		return -1;
+	}
+	return 0;
+}
+
+static void close_stream(struct stream *s)
+{
+	int status;
+
+	fclose(s->f);
+	if (s->pid > 0)
+		waitpid(s->pid, &status, 0);
+	free(s->mem);
+}
+
+struct arg {
+	FILE *f;
+	int op;
+	size_t n;
+	size_t done;
+};
+
+static void *run(void *p)
+{
+	struct arg *a = p;
+
+	a->done = op[a->op].f(a->f, a->n);
+	return 0;
+}
+
+/* a sample is one transfer on a stream opened (and the previous one closed) in setup */
+static struct bench {
+	int kind, b, o, nthread;
+	size_t n;
+	int open, err;
+	struct stream s;
+	struct arg a[NTHREAD];
+	long long c0, calls, overhead;
+	size_t bytes;
+} bn;
+
+static void finish(void)
+{
+	size_t done;
+	long long c1;
+	int i;
+
+	if (!bn.open)
+		return;
+	c1 = syscalls();
+	close_stream(&bn.s);
+	bn.open = 0;
+	if (bn.c0 < 0 || c1 < 0 || bn.calls < 0)
+		bn.calls = -1;
+	else
+		bn.calls += c1 - bn.c0 - bn.overhead;
+	for (done = i = 0; i < bn.nthread; i++)
+		done += bn.a[i].done;
+	if (done != bn.n / bn.nthread * bn.nthread && !bn.err) {
+		t_error("%s %s %s: transferred %zu bytes, want %zu\n",
+			kindname[bn.kind], buffering[bn.b].name, op[bn.o].name,
+			done, bn.n / bn.nthread * bn.nthread);
+		bn.err = 1;
+	}
+	bn.bytes += done;
+}
+
+static void setup(void *p)
+{
+	int i;
+
+	finish();
+	if (bn.err || open_stream(&bn.s, bn.kind, op[bn.o].write)) {
+		bn.err = 1;
+		return;
+	}
+	bn.open = 1;
+	if (setvbuf(bn.s.f, buffering[bn.b].mode == _IONBF ? 0 : vbuf, buffering[bn.b].mode, buffering[bn.b].size)) {
+		t_error("setvbuf failed\n");
+		bn.err = 1;
+		return;
+	}
+	for (i = 0; i < bn.nthread; i++) {
+		bn.a[i].f = bn.s.f;
+		bn.a[i].op = bn.o;
+		bn.a[i].n = bn.n / bn.nthread;
+		bn.a[i].done = 0;
+	}
+	bn.c0 = syscalls();
+}
+
+static void transfer(void *p)
+{
+	pthread_t td[NTHREAD];
+	int i, r;
+
+	if (bn.err)
+		return;
+	if (bn.nthread == 1)
+		run(bn.a);
+	else {
+		for (i = 0; i < bn.nthread; i++)
+			if ((r = pthread_create(td + i, 0, run, bn.a + i))) {
+				t_error("pthread_create failed: %s\n", strerror(r));
+				bn.err = 1;
+				break;
+			}
+		while (i--)
+			pthread_join(td[i], 0);
+	}
+	if (op[bn.o].write)
+		fflush(bn.s.f);
+}
+
+static void bench(int kind, int b, int o, int nthread, long long overhead)
+{
+	struct t_bench tb;
+	char name[64];
+	int r;
+
+	/* unbuffered streams are measured on less data */
+	bn = (struct bench){.kind = kind, .b = b, .o = o, .nthread = nthread,
+		.n = buffering[b].mode == _IONBF ? NNBF : N, .overhead = overhead};
+	snprintf(name, sizeof name, "stdio %s %s %zu %s %dthr", kindname[kind],
+		buffering[b].name, buffering[b].size, op[o].name, nthread);
+	r = t_benchlat(&tb, name, setup, transfer, 0);
+	finish();
+	if (r < 0 || bn.err || !bn.bytes)
+		return;
+	printf("%-4s %s %5zu %-13s %d thr %8.1f MB/s", kindname[kind],
+		buffering[b].name, buffering[b].size, op[o].name, nthread,
+		bn.n / nthread * nthread / tb.med * 1e-6);
+	if (bn.calls >= 0)
+		printf(" %9.1f syscalls/MB\n", bn.calls * 1e6 / bn.bytes);
+	else
+		printf("       n/a syscalls/MB\n");
+}
+
+int main(void)
+{
+	long long overhead;
+	size_t i;
+	int fd, kind, b, o;
+
+	signal(SIGPIPE, SIG_IGN);
+	for (i = 0; i < N; i++)
+		data[i] = i % LINE == LINE-1 ? '\n' : 'a' + i % 26;
+	fd = mkstemp(wpath);
+	if (fd < 0) {
+		t_error("mkstemp failed: %s\n", strerror(errno));
+		return t_status;
+	}
+	close(fd);
+	fd = mkstemp(path);
+	if (fd < 0) {
+		t_error("mkstemp failed: %s\n", strerror(errno));
+		unlink(wpath);
+		return t_status;
+	}
+	if (write(fd, data, N) != N) {
+		t_error("write failed: %s\n", strerror(errno));
+		close(fd);
+		unlink(path);
+		unlink(wpath);
+		return t_status;
+	}
+	close(fd);
+
+	/* syscalls made by the measurement itself */
+	overhead = syscalls();
+	overhead = syscalls() - overhead;
+
+	for (kind = FILE_; kind <= MEM; kind++)
+		for (b = 0; b < sizeof buffering/sizeof *buffering; b++)
+			for (o = 0; o < sizeof op/sizeof *op; o++) {
+				bench(kind, b, o, 1, overhead);
+				bench(kind, b, o, NTHREAD, overhead);
+			}
+	unlink(path);
+	unlink(wpath);
+	return t_status;
+}
@@ -0,0 +1,344 @@
+// time conversion and formatting throughput
+// localtime_r, gmtime_r, mktime, timegm, strftime and strptime per call
+// cost under POSIX TZ strings and a locally generated zoneinfo file, the
+// cost of the first conversion after a TZ change (rule parsing or file
+// loading) and the latency of clock_gettime per clock id through libc
+// (vdso if available) compared with the raw syscall
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include "test.h"
+
+#define NT 1024
+
+static char zpath[] = "/tmp/libc-test-bench-tzif-XXXXXX";
+static char ztz[sizeof zpath + 1];
+
+/* hour is the local hour at 1500000000 (2017-07-14 02:40:00 UTC) */
+static struct {
+	char *name;
+	char *tz;
+	int hour;
+} zone[] = {
+	{"utc", "UTC0", 2},
+	{"posix-eu", "CET-1CEST,M3.5.0,M10.5.0/3", 4},
+	{"posix-us", "EST5EDT,M3.2.0,M11.1.0", 22},
+	{"tzif", ztz, 4},
+};
+
+static time_t ts[NT];
+static struct tm tms[NT];
+static char strs[NT][64];
+static const char fmt[] = "%d/%b/%Y:%H:%M:%S";
+
+/* days since 1970-01-01 of a proleptic gregorian date, m in 1..12 */
+static long days(long y, int m, int d)
+{
+	y -= m <= 2;
+	long era = (y >= 0 ? y : y-399) / 400;
+	long yoe = y - era * 400;
+	long doy = (153*(m + (m > 2 ? -3 : 9)) + 2)/5 + d-1;
+	long doe = yoe * 365 + yoe/4 - yoe/100 + doy;
+	return era * 146097 + doe - 719468;
+}
+
+/* day of the last sunday of the month */
+static long lastsun(long y, int m)
+{
+	long d = m == 12 ? days(y+1, 1, 1) - 1 : days(y, m+1, 1) - 1;
+	/* 1970-01-01 was a thursday */
+	return d - (d + 4) % 7;
+}
+
+static void put32(unsigned char *p, long long v)
+{
+	p[0] = v >> 24;
+	p[1] = v >> 16;
+	p[2] = v >> 8;
+	p[3] = v;
+}
+
+static void put64(unsigned char *p, long long v)
+{
+	put32(p, v >> 32);
+	put32(p+4, v);
+}
+
+/* write a TZif2 file with the EU rules from 1970 to 2037 and a TZ footer */
+static int gentzif(int fd)
+{
+	static unsigned char buf[1<<14];
+	static long long tr[2*68];
+	unsigned char *p;
+	int i, n, pass;
+
+	for (n = 0, i = 1970; i < 2038; i++) {
+		tr[n++] = lastsun(i, 3) * 86400LL + 3600;
+		tr[n++] = lastsun(i, 10) * 86400LL + 3600;
+	}
+	p = buf;
+	for (pass = 0; pass < 2; pass++) {
+		int w = pass ? 8 : 4;
+
+		memcpy(p, "TZif2", 5);
+		memset(p+5, 0, 15);
+		p += 20;
+		put32(p, 0);     /* isutcnt */
+		put32(p+4, 0);   /* isstdcnt */
+		put32(p+8, 0);   /* leapcnt */
+		put32(p+12, n);  /* timecnt */
+		put32(p+16, 2);  /* typecnt */
+		put32(p+20, 10); /* charcnt */
+		p += 24;
+		for (i = 0; i < n; i++, p += w)
+			(pass ? put64 : put32)(p, tr[i]);
+		for (i = 0; i < n; i++)
+			*p++ = i % 2 == 0;
+		put32(p, 3600);
+		p[4] = 0;
+		p[5] = 0;
+		put32(p+6, 7200);
+		p[10] = 1;
+		p[11] = 4;
+		p += 12;
+		memcpy(p, "CET\0CEST\0\0", 10);
+		p += 10;
+	}
+	p += sprintf((char *)p, "\nCET-1CEST,M3.5.0,M10.5.0/3\n");
+	return write(fd, buf, p - buf) == p - buf ? 0 : -1;
+}
+
+static int settz(const char *tz)
+{
+	if (setenv("TZ", tz, 1)) {
+		t_error("setenv TZ=%s failed: %s\n", tz, strerror(errno));
+		return -1;
+	}
+	tzset();
+	return 0;
+}
+
+static volatile long sink;
+
+static void f_localtime(int i) { sink += localtime_r(ts + i, tms + i)->tm_hour; }
+static void f_gmtime(int i) { sink += gmtime_r(ts + i, tms + i)->tm_hour; }
+static void f_mktime(int i) { struct tm tm = tms[i]; sink += mktime(&tm); }
+static void f_timegm(int i) { struct tm tm = tms[i]; sink += timegm(&tm); }
+static void f_strftime(int i) { sink += strftime(strs[i], sizeof strs[i], fmt, tms + i); }
+static void f_strptime(int i) { struct tm tm = {0}; sink += !!strptime(strs[i], fmt, &tm); }
+
+static struct func {
+	char *name;
+	void (*f)(int);
+} func[] = {
+	{"localtime_r", f_localtime},
+	{"gmtime_r", f_gmtime},
+	{"mktime", f_mktime},
+	{"timegm", f_timegm},
+	{"strftime", f_strftime},
+	{"strptime", f_strptime},
+};
+
+/* an iteration is a pass over the timestamp set */
+static void run(void *p, long n)
+{
+	struct func *fn = p;
+	int i;
+
+	while (n--)
+		for (i = 0; i < NT; i++)
+			fn->f(i);
+}
+
+/* ns per call of f */
+static double measure(struct func *fn, const char *zone, const char *set)
+{
+	struct t_bench b;
+	char name[64];
+
+	snprintf(name, sizeof name, "time %s %s %s", zone, set, fn->name);
+	if (t_bench(&b, name, run, fn) < 0)
+		return 0;
+	return b.med / NT * 1e9;
+}
+
+/* prepare inputs (in the current TZ) and check round trips */
+static void setup(const char *name, int seq)
+{
+	struct tm tm;
+	time_t t;
+	int i;
+
+	for (i = 0; i < NT; i++) {
+		/* log-like consecutive seconds or random times in 1970..2037 */
+		ts[i] = seq ? 1500000000 + i : (time_t)t_randn(2145916800);
+		localtime_r(ts + i, tms + i);
+		strftime(strs[i], sizeof strs[i], fmt, tms + i);
+		tm = tms[i];
+		if ((t = mktime(&tm)) != ts[i])
+			t_error("%s: mktime(localtime_r(%lld)) = %lld\n", name, (long long)ts[i], (long long)t);
+		memset(&tm, 0, sizeof tm);
+		if (!strptime(strs[i], fmt, &tm) || tm.tm_sec != tms[i].tm_sec ||
+		    tm.tm_min != tms[i].tm_min || tm.tm_hour != tms[i].tm_hour ||
+		    tm.tm_mday != tms[i].tm_mday || tm.tm_mon != tms[i].tm_mon ||
+		    tm.tm_year != tms[i].tm_year)
+			t_error("%s: strptime(\"%s\") failed to round trip\n", name, strs[i]);
+	}
+}
+
+static const char *newtz;
+static const time_t tref = 1500000000;
+
+/* back to UTC with its rules loaded */
+static void utc(void *p)
+{
+	struct tm tm;
+
+	settz("UTC0");
+	localtime_r(&tref, &tm);
+}
+
+static void utcnew(void *p)
+{
+	utc(p);
+	settz(newtz);
+}
+
+static void f_settz(void *p)
+{
+	settz(newtz);
+}
+
+static void f_first(void *p)
+{
+	struct tm tm;
+
+	sink += localtime_r(&tref, &tm)->tm_hour;
+}
+
+/* tzset and first localtime_r after switching from UTC */
+static void tzswitch(const char *name, const char *tz)
+{
+	struct t_bench bset, bfirst;
+	char nset[64], nfirst[64];
+
+	newtz = tz;
+	snprintf(nset, sizeof nset, "time %s tzset", name);
+	snprintf(nfirst, sizeof nfirst, "time %s first localtime_r", name);
+	if (t_benchlat(&bset, nset, utc, f_settz, 0) < 0 ||
+	    t_benchlat(&bfirst, nfirst, utcnew, f_first, 0) < 0)
+		return;
+	printf("%-9s tz change: tzset %8.1f ns, first localtime_r %8.1f ns\n",
+		name, bset.med * 1e9, bfirst.med * 1e9);
+}
+
+static struct {
+	char *name;
+	clockid_t id;
+} clk[] = {
+	{"realtime", CLOCK_REALTIME},
+	{"monotonic", CLOCK_MONOTONIC},
+	{"process_cputime", CLOCK_PROCESS_CPUTIME_ID},
+	{"thread_cputime", CLOCK_THREAD_CPUTIME_ID},
+#ifdef CLOCK_MONOTONIC_RAW
+	{"monotonic_raw", CLOCK_MONOTONIC_RAW},
+#endif
+#ifdef CLOCK_REALTIME_COARSE
+	{"realtime_coarse", CLOCK_REALTIME_COARSE},
+#endif
+#ifdef CLOCK_MONOTONIC_COARSE
+	{"monotonic_coarse", CLOCK_MONOTONIC_COARSE},
+#endif
+#ifdef CLOCK_BOOTTIME
+	{"boottime", CLOCK_BOOTTIME},
+#endif
+};
+
+static void run_clock(void *p, long n)
+{
+	clockid_t id = *(clockid_t *)p;
+	struct timespec t;
+
+	while (n--)
+		clock_gettime(id, &t);
+}
+
+static void run_syscall(void *p, long n)
+{
+	struct timespec t;
+
+#ifdef SYS_clock_gettime
+	clockid_t id = *(clockid_t *)p;
+
+	while (n--)
+		syscall(SYS_clock_gettime, id, &t);
+#endif
+}
+
+/* ns per clock_gettime call through libc or as a raw syscall */
+static double clocklat(int i, int raw)
+{
+	struct t_bench b;
+	char name[64];
+
+	snprintf(name, sizeof name, "clock_gettime %s %s", clk[i].name, raw ? "syscall" : "libc");
+	if (t_bench(&b, name, raw ? run_syscall : run_clock, &clk[i].id) < 0)
+		return 0;
+	return b.med * 1e9;
+}
+
+int main(void)
+{
+	struct timespec t;
+	size_t i, j;
+	int fd, seq;
+
+	fd = mkstemp(zpath);
+	if (fd < 0) {
+		t_error("mkstemp failed: %s\n", strerror(errno));
+		return t_status;
+	}
+	if (gentzif(fd))
+		t_error("writing %s failed: %s\n", zpath, strerror(errno));
+	close(fd);
+	snprintf(ztz, sizeof ztz, ":%s", zpath);
+
+	for (i = 0; i < sizeof zone/sizeof *zone; i++) {
+		time_t t0 = 1500000000;
+		struct tm tm;
+
+		if (settz(zone[i].tz))
+			continue;
+		if (localtime_r(&t0, &tm)->tm_hour != zone[i].hour)
+			t_error("TZ=%s: localtime_r(%lld) hour is %d, want %d\n",
+				zone[i].tz, (long long)t0, tm.tm_hour, zone[i].hour);
+		for (seq = 1; seq >= 0; seq--) {
+			setup(zone[i].name, seq);
+			printf("%-9s %-6s", zone[i].name, seq ? "seq" : "random");
+			for (j = 0; j < sizeof func/sizeof *func; j++)
+				printf(" %s %6.1f ns", func[j].name,
+					measure(func + j, zone[i].name, seq ? "seq" : "random"));
+			printf("\n");
+		}
+		tzswitch(zone[i].name, zone[i].tz);
+	}
+	unlink(zpath);
+
+	for (i = 0; i < sizeof clk/sizeof *clk; i++) {
+		if (clock_gettime(clk[i].id, &t)) {
+			printf("clock_gettime %-16s n/a\n", clk[i].name);
+			continue;
+		}
+		printf("clock_gettime %-16s libc %6.1f ns", clk[i].name, clocklat(i, 0));
+#ifdef SYS_clock_gettime
+		printf(" syscall %6.1f ns", clocklat(i, 1));
+#endif
+		printf("\n");
+	}
+	return t_status;
+}
@@ -0,0 +1,393 @@
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <dlfcn.h>
+#include <sys/mman.h>
+#include "test.h"
+
+/*
+allocation counting: this object replaces malloc, calloc, realloc, free
+and the aligned allocation functions, it is not part of libtest.a so the
+malloc tests keep testing the libc allocator, tests using t_alloccount
+add it in their .mk file:
+
+$(N).OBJS := $(B)/common/alloccount.o
+$(N)-static.OBJS := $(B)/common/alloccount.o
+
+in dynamic binaries the calls are counted and passed on to the libc
+allocator found with dlsym(RTLD_NEXT), dlsym is a weak reference so a
+static binary does not pull it in and uses the simple allocator below
+instead (static linking allows replacing malloc if all of these
+functions are replaced). calls made while dlsym looks up the libc
+allocator are served from a small static buffer that is never freed.
+
+it also fails allocation calls for t_allocfail and t_allocsweep with
+T_AFMALLOC (through t_mallocfail), that reaches the allocations libc
+serves from its heap without a syscall.
+*/
+
+#pragma weak dlsym
+
+static struct {
+	void *(*malloc)(size_t);
+	void *(*calloc)(size_t, size_t);
+	void *(*realloc)(void *, size_t);
+	void (*free)(void *);
+	int (*memalign)(void **, size_t, size_t);
+	size_t (*usable)(void *);
+	int state;   /* 0: not looked up, 1: looking up, 2: done */
+} next;
+
+static volatile int counting;
+static volatile struct t_alloc cnt;
+
+/* malloc level failures, off if n < 0 */
+static volatile struct {
+	long n;
+	long count;
+	int once;
+	volatile long *shared;
+} fail = {-1};
+
+static void init(void)
+{
+	next.state = 1;
+	if (dlsym) {
+		next.malloc = dlsym(RTLD_NEXT, "malloc");
+		next.calloc = dlsym(RTLD_NEXT, "calloc");
+		next.realloc = dlsym(RTLD_NEXT, "realloc");
+		next.free = dlsym(RTLD_NEXT, "free");
+		next.memalign = dlsym(RTLD_NEXT, "posix_memalign");
+		next.usable = dlsym(RTLD_NEXT, "malloc_usable_size");
+	}
+	if (!next.malloc || !next.calloc || !next.realloc || !next.free || !next.memalign)
+		next.malloc = 0;
+	next.state = 2;
+}
+
+/* libc allocator or 0 if the own one is used */
+static int libc(void)
+{
+	if (next.state == 0)
+		init();
+	return next.state == 2 && next.malloc;
+}
+
+static void count(volatile long *n, size_t bytes)
+{
+	if (counting) {
+		__sync_fetch_and_add(n, 1);
+		__sync_fetch_and_add(&cnt.bytes, bytes);
+	}
+}
+
+/* count an allocation call, 1 if it fails */
+static int failed(void)
+{
+	long c;
+
+	if (fail.n < 0)
+		return 0;
+	c = __sync_fetch_and_add(&fail.count, 1);
+	if (fail.shared)
+		*fail.shared = c + 1;
+	if (fail.once ? c != fail.n : c < fail.n)
+		return 0;
+	errno = ENOMEM;
+	return 1;
+}
+
+/*
+the own allocator: power of two size classes with free lists, carved
+from 1M mmap chunks, large blocks are mapped directly. the header before
+each block holds its class (or its mapping size) and the offset from the
+start of the block for aligned allocations.
+*/
+
+struct hdr {
+	size_t size;    /* class size or mapping size */
+	size_t off;     /* aligned pointer - block start */
+	void *next;     /* free list link while free */
+	size_t pad;
+};
+
+/* the largest class fits a chunk */
+enum {MINCLASS = 5, NCLASS = 16, CHUNK = 1<<20};
+
+static volatile int lock;
+static void *freelist[NCLASS];
+static char *chunk, *chunkend;
+static char boot[4096];
+static size_t bootused;
+
+static void acquire(void)
+{
+	while (__sync_lock_test_and_set(&lock, 1));
+}
+
+static void release(void)
+{
+	__sync_lock_release(&lock);
+}
+
+static void *bootalloc(size_t n)
+{
+	void *p;
+
+	n = (n + 15) & -16;
+	if (n > sizeof boot - bootused)
+		return 0;
+	p = boot + bootused;
+	bootused += n;
+	return p;
+}
+
+static int isboot(void *p)
+{
+	return (char *)p >= boot && (char *)p < boot + sizeof boot;
+}
+
+static struct hdr *blockof(void *p)
+{
+	struct hdr *h = (struct hdr *)p - 1;
+
+	return (struct hdr *)((char *)h - h->off);
+}
+
+static void *own_alloc(size_t n, size_t align)
+{
+	struct hdr *h;
+	size_t need, sz;
+	int c;
+	char *p;
+
+	if (align < sizeof(struct hdr))
+		align = sizeof(struct hdr);
+	if (n > SIZE_MAX/2 - align) {
+		errno = ENOMEM;
+		return 0;
+	}
+	need = sizeof *h + n + align - sizeof(struct hdr);
+	for (c = 0; c < NCLASS && ((size_t)1 << (c + MINCLASS)) < need; c++);
+	if (c == NCLASS) {
+		sz = (need + 4095) & -4096;
+		p = mmap(0, sz, PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_ANONYMOUS, -1, 0);
+		if (p == MAP_FAILED) {
+			errno = ENOMEM;
+			return 0;
+		}
+		h = (struct hdr *)p;
+		h->size = sz;
+	} else {
+		sz = (size_t)1 << (c + MINCLASS);
+		acquire();
+		if ((h = freelist[c])) {
+			freelist[c] = h->next;
+		} else {
+			if (chunkend - chunk < sz) {
+				p = mmap(0, CHUNK, PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_ANONYMOUS, -1, 0);
+				if (p == MAP_FAILED) {
+					release();
+					errno = ENOMEM;
+					return 0;
+				}
+				chunk = p;
+				chunkend = p + CHUNK;
+			}
+			h = (struct hdr *)chunk;
+			chunk += sz;
+		}
+		release();
+		h->size = sz;
+	}
+	/* the user pointer is aligned, its header records the block */
+	p = (char *)(h + 1);
+	p += -(uintptr_t)p & (align - 1);
+	((struct hdr *)p - 1)->off = (char *)((struct hdr *)p - 1) - (char *)h;
+	if ((struct hdr *)p - 1 != h)
+		((struct hdr *)p - 1)->size = 0;
+	h->off = 0;
+	return p;
+}
+
+static size_t own_usable(void *p)
+{
+	struct hdr *h = blockof(p);
+
+	return (char *)h + h->size - (char *)p;
+}
+
+static void own_free(void *p)
+{
+	struct hdr *h = blockof(p);
+	int c;
+
+	if (h->size > (size_t)1 << (NCLASS - 1 + MINCLASS)) {
+		munmap(h, h->size);
+		return;
+	}
+	for (c = 0; ((size_t)1 << (c + MINCLASS)) < h->size; c++);
+	acquire();
+	h->next = freelist[c];
+	freelist[c] = h;
+	release();
+}
+
+void *malloc(size_t n)
+{
+	count(&cnt.malloc, n);
+	if (next.state == 1)
+		return bootalloc(n);
+	if (failed())
+		return 0;
+	if (libc())
+		return next.malloc(n);
+	return own_alloc(n, 16);
+}
+
+void *calloc(size_t m, size_t n)
+{
+	void *p;
+
+	if (n && m > SIZE_MAX/n) {
+		errno = ENOMEM;
+		return 0;
+	}
+	count(&cnt.calloc, m*n);
+	if (next.state == 1)
+		return bootalloc(m*n);
+	if (failed())
+		return 0;
+	if (libc())
+		return next.calloc(m, n);
+	p = own_alloc(m*n, 16);
+	if (p)
+		memset(p, 0, m*n);
+	return p;
+}
+
+void *realloc(void *p, size_t n)
+{
+	void *q;
+	size_t old;
+
+	count(&cnt.realloc, n);
+	if (p && isboot(p)) {
+		/* the size of a boot block is not known, copy what fits */
+		q = malloc(n);
+		if (q)
+			memcpy(q, p, boot + sizeof boot - (char *)p < n ? boot + sizeof boot - (char *)p : n);
+		return q;
+	}
+	if (next.state == 1)
+		return bootalloc(n);
+	if (failed())
+		return 0;
+	if (libc())
+		return next.realloc(p, n);
+	if (!p)
+		return own_alloc(n, 16);
+	old = own_usable(p);
+	if (n <= old && n > old/2)
+		return p;
+	q = own_alloc(n, 16);
+	if (q) {
+		memcpy(q, p, n < old ? n : old);
+		own_free(p);
+	}
+	return q;
+}
+
+void free(void *p)
+{
+	if (!p)
+		return;
+	count(&cnt.free, 0);
+	if (isboot(p))
+		return;
+	if (libc())
+		next.free(p);
+	else
+		own_free(p);
+}
+
+int posix_memalign(void **res, size_t align, size_t n)
+{
+	void *p;
+
+	if (align < sizeof(void *) || (align & (align - 1)))
+		return EINVAL;
+	count(&cnt.malloc, n);
+	if (next.state == 1 || failed())
+		return ENOMEM;
+	if (libc())
+		return next.memalign(res, align, n);
+	if (!(p = own_alloc(n, align)))
+		return ENOMEM;
+	*res = p;
+	return 0;
+}
+
+void *aligned_alloc(size_t align, size_t n)
+{
+	void *p;
+	int r;
+
+	if (align < sizeof(void *))
+		align = sizeof(void *);
+	if ((r = posix_memalign(&p, align, n))) {
+		errno = r;
+		return 0;
+	}
+	return p;
+}
+
+void *memalign(size_t align, size_t n)
+{
+	return aligned_alloc(align, n);
+}
+
+size_t malloc_usable_size(void *p)
+{
+	if (!p || isboot(p))
+		return 0;
+	if (libc())
+		return next.usable ? next.usable(p) : 0;
+	return own_usable(p);
+}
+
+/* start counting the allocation calls and the allocated bytes from now */
+void t_alloccount(void)
+{
+	counting = 0;
+	cnt.malloc = cnt.calloc = cnt.realloc = cnt.free = 0;
+	cnt.bytes = 0;
+	counting = 1;
+}
+
+/* the counts since t_alloccount */
+void t_allocs(struct t_alloc *c)
+{
+	c->malloc = cnt.malloc;
+	c->calloc = cnt.calloc;
+	c->realloc = cnt.realloc;
+	c->free = cnt.free;
+	c->bytes = cnt.bytes;
+}
+
+/*
+for sysfail.c: from now on the first n allocation calls succeed and the
+following ones fail with ENOMEM (only the next one if once), n < 0 stops
+it. the calls are also counted in *shared if it is not 0.
+*/
+int t_mallocfail(long n, int once, volatile long *shared)
+{
+	fail.n = -1;
+	fail.count = 0;
+	fail.once = once;
+	fail.shared = shared;
+	fail.n = n;
+	return 0;
+}
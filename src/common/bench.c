@@ -0,0 +1,317 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <math.h>
+#include <time.h>
+#include <sched.h>
+#include <stdint.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#include "test.h"
+
+/*
+micro-benchmarks: f(arg, n) runs the measured code n times.
+
+the iteration count is calibrated so that a sample takes about SAMPLE
+seconds, then a warm-up sample is thrown away and samples are taken
+until NMAX are done or BUDGET seconds passed (but at least NMIN). the
+results are per iteration: median and MAD (median absolute deviation)
+of all samples, samples further than 5 MADs from the median are outliers
+(interrupts, migration, frequency changes) and the percentiles, min and
+max are of the rest. the thread is pinned to its cpu while measuring.
+
+t_benchlat measures the latency of single operations instead. a sample
+is one call f(arg), so iter is 1, and up to NLAT samples are taken. if
+setup is not 0 it runs before each sample to prepare or reap what the
+operation uses, outside the timed region and with the counters stopped.
+the outliers are counted but kept in the percentiles, min and max.
+
+runtest exports the time it kills the test at in T_DEADLINE (monotonic
+seconds), near it fewer samples are taken so the benchmark ends with
+results.
+
+hardware counters of the measuring thread (user space only) are read
+with perf_event_open over all the samples: cycles, instructions, cache,
+branch and data tlb misses per iteration, -1 if a counter cannot be
+opened (no pmu, perf_event_paranoid, seccomp). multiplexed counters are
+scaled to the full time.
+
+if T_BENCHCSV names a file, a csv record is appended to it for each
+benchmark, the counters are empty if not available:
+
+name,iter,samples,outliers,median_ns,mad_ns,p90_ns,p99_ns,min_ns,max_ns,
+ipc,cycles,instructions,cache_misses,branch_misses,tlb_misses
+*/
+
+#define SAMPLE 1e-3
+#define BUDGET 0.2
+#define MARGIN 1.0
+enum {NMIN = 5, NMAX = 101, NLAT = 10001};
+
+static const struct {
+	uint32_t type;
+	uint64_t config;
+} counter[] = {
+	{PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+	{PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+	{PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+	{PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+	{PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_DTLB |
+		PERF_COUNT_HW_CACHE_OP_READ << 8 | PERF_COUNT_HW_CACHE_RESULT_MISS << 16},
+};
+#define NCOUNTER (sizeof counter / sizeof *counter)
+
+static void pmu_open(int *fd)
+{
+	struct perf_event_attr a;
+	int i;
+
+	for (i = 0; i < NCOUNTER; i++) {
+		memset(&a, 0, sizeof a);
+		a.size = sizeof a;
+		a.type = counter[i].type;
+		a.config = counter[i].config;
+		a.disabled = 1;
+		a.exclude_kernel = 1;
+		a.exclude_hv = 1;
+		a.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED|PERF_FORMAT_TOTAL_TIME_RUNNING;
+		fd[i] = syscall(SYS_perf_event_open, &a, 0, -1, -1, 0);
+	}
+}
+
+static void pmu_ctl(int *fd, int req)
+{
+	int i;
+
+	for (i = 0; i < NCOUNTER; i++)
+		if (fd[i] >= 0)
+			ioctl(fd[i], req, 0);
+}
+
+/* per iteration counts, closes the counters */
+static void pmu_read(int *fd, double *c, long iter)
+{
+	uint64_t v[3];
+	int i;
+
+	for (i = 0; i < NCOUNTER; i++) {
+		c[i] = -1;
+		if (fd[i] < 0)
+			continue;
+		if (read(fd[i], v, sizeof v) == sizeof v && v[2])
+			c[i] = (double)v[0] * v[1] / v[2] / iter;
+		close(fd[i]);
+	}
+}
+
+static double now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec*1e-9;
+}
+
+static double deadline(void)
+{
+	static double d = -1;
+	char *s;
+
+	if (d < 0) {
+		s = getenv("T_DEADLINE");
+		d = s ? strtod(s, 0) - MARGIN : 0;
+	}
+	return d;
+}
+
+struct run {
+	void (*f)(void *, long);
+	void (*op)(void *);
+	void (*setup)(void *);
+	void *arg;
+};
+
+static double sample(const struct run *r, long n, int *fd)
+{
+	double t;
+
+	if (r->setup) {
+		if (fd)
+			pmu_ctl(fd, PERF_EVENT_IOC_DISABLE);
+		r->setup(r->arg);
+		if (fd)
+			pmu_ctl(fd, PERF_EVENT_IOC_ENABLE);
+	}
+	t = now();
+	if (r->op)
+		r->op(r->arg);
+	else
+		r->f(r->arg, n);
+	return now() - t;
+}
+
+static int cmp(const void *a, const void *b)
+{
+	double x = *(const double *)a, y = *(const double *)b;
+
+	return x < y ? -1 : x > y;
+}
+
+static double median(double *x, int n)
+{
+	qsort(x, n, sizeof *x, cmp);
+	return n % 2 ? x[n/2] : (x[n/2-1] + x[n/2]) / 2;
+}
+
+static void csv(const char *name, const struct t_bench *b)
+{
+	char buf[512];
+	char *file = getenv("T_BENCHCSV");
+	double c[] = {b->cycles, b->insn, b->cachemiss, b->branchmiss, b->tlbmiss};
+	int fd, n, i;
+
+	if (!file || !*file)
+		return;
+	n = snprintf(buf, sizeof buf, "%s,%ld,%d,%d,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,",
+		name, b->iter, b->n, b->outliers, b->med*1e9, b->mad*1e9,
+		b->p90*1e9, b->p99*1e9, b->min*1e9, b->max*1e9);
+	if (b->cycles > 0 && b->insn >= 0 && n < sizeof buf)
+		n += snprintf(buf+n, sizeof buf-n, "%.3f", b->insn / b->cycles);
+	for (i = 0; i < sizeof c / sizeof *c && n < sizeof buf; i++)
+		n += c[i] < 0 ? snprintf(buf+n, sizeof buf-n, ",") :
+			snprintf(buf+n, sizeof buf-n, ",%.3f", c[i]);
+	if (n < sizeof buf)
+		n += snprintf(buf+n, sizeof buf-n, "\n");
+	if (n >= sizeof buf)
+		return;
+	/* one append per record so concurrent benchmarks can share the file */
+	fd = open(file, O_WRONLY|O_CREAT|O_APPEND, 0644);
+	if (fd < 0) {
+		t_error("%s: cannot open\n", file);
+		return;
+	}
+	write(fd, buf, n);
+	close(fd);
+}
+
+/* the samples are static, a benchmark runs in one thread at a time */
+static double x[NLAT], d[NLAT];
+
+static int bench(struct t_bench *b, const char *name, const struct run *r)
+{
+	double c[NCOUNTER], t, end, hard;
+	cpu_set_t old, one;
+	int fd[NCOUNTER], pinned, cpu, i, k, m, nmax;
+	long n;
+
+	memset(b, 0, sizeof *b);
+	hard = deadline();
+	end = now() + BUDGET;
+	if (hard && end > hard)
+		end = hard;
+	if (hard && now() > hard)
+		return -1;
+
+	cpu = sched_getcpu();
+	pinned = cpu >= 0 && sched_getaffinity(0, sizeof old, &old) == 0;
+	if (pinned) {
+		CPU_ZERO(&one);
+		CPU_SET(cpu, &one);
+		pinned = sched_setaffinity(0, sizeof one, &one) == 0;
+	}
+
+	/* calibration, the last one is the warm-up */
+	for (n = 1; ; n *= 2) {
+		t = sample(r, n, 0);
+		if (r->op || t >= SAMPLE || now() > end || n > LONG_MAX/4)
+			break;
+	}
+	if (t > 2*SAMPLE && n > 1)
+		n /= 2;
+	nmax = r->op ? NLAT : NMAX;
+	pmu_open(fd);
+	pmu_ctl(fd, PERF_EVENT_IOC_RESET);
+	pmu_ctl(fd, PERF_EVENT_IOC_ENABLE);
+	for (k = 0; k < nmax; k++) {
+		if (k >= NMIN && now() > end)
+			break;
+		if (k && hard && now() > hard)
+			break;
+		x[k] = sample(r, n, fd) / n;
+	}
+	pmu_ctl(fd, PERF_EVENT_IOC_DISABLE);
+	pmu_read(fd, c, n * k);
+	b->cycles = c[0];
+	b->insn = c[1];
+	b->cachemiss = c[2];
+	b->branchmiss = c[3];
+	b->tlbmiss = c[4];
+
+	if (pinned)
+		sched_setaffinity(0, sizeof old, &old);
+
+	b->iter = n;
+	m = k;
+	b->med = median(x, k);
+	for (i = 0; i < k; i++)
+		d[i] = fabs(x[i] - b->med);
+	b->mad = median(d, k);
+	/* x is sorted, drop the outliers from both ends */
+	for (i = 0; i < k && b->med - x[i] > 5*b->mad && b->mad > 0; i++);
+	while (k > i+1 && x[k-1] - b->med > 5*b->mad && b->mad > 0)
+		k--;
+	b->n = k - i;
+	b->outliers = m - b->n;
+	/* the tail is the point of latencies, the outliers are kept */
+	if (r->op) {
+		i = 0;
+		k = b->n = m;
+	}
+	b->min = x[i];
+	b->max = x[k-1];
+	b->p90 = x[i + (k - i - 1) * 90 / 100];
+	b->p99 = x[i + (k - i - 1) * 99 / 100];
+	if (name)
+		csv(name, b);
+	return 0;
+}
+
+/* measure f, returns -1 if no sample could be taken before the deadline */
+int t_bench(struct t_bench *b, const char *name, void (*f)(void *, long), void *arg)
+{
+	struct run r = {f, 0, 0, arg};
+
+	return bench(b, name, &r);
+}
+
+/* measure single calls of f with setup before each, -1 as t_bench */
+int t_benchlat(struct t_bench *b, const char *name, void (*setup)(void *), void (*f)(void *), void *arg)
+{
+	struct run r = {0, f, setup, arg};
+
+	return bench(b, name, &r);
+}
+
+/* one line of the results in ns per iteration and the counters per iteration */
+void t_benchprint(const char *name, const struct t_bench *b)
+{
+	char buf[256];
+	int n = 0;
+
+	if (b->cycles > 0 && b->insn >= 0)
+		n += snprintf(buf+n, sizeof buf-n, " ipc %4.2f cyc %8.1f", b->insn / b->cycles, b->cycles);
+	if (b->cachemiss >= 0 && n < sizeof buf)
+		n += snprintf(buf+n, sizeof buf-n, " cache-miss %7.3f", b->cachemiss);
+	if (b->branchmiss >= 0 && n < sizeof buf)
+		n += snprintf(buf+n, sizeof buf-n, " branch-miss %7.3f", b->branchmiss);
+	if (b->tlbmiss >= 0 && n < sizeof buf)
+		n += snprintf(buf+n, sizeof buf-n, " tlb-miss %7.3f", b->tlbmiss);
+	buf[n < sizeof buf ? n : sizeof buf - 1] = 0;
+	printf("%-32s %10.1f ns mad %5.1f%% p99 %10.1f ns%s\n", name, b->med*1e9,
+		b->med ? 100*b->mad/b->med : 0, b->p99*1e9, buf);
+}
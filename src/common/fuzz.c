@@ -0,0 +1,479 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <signal.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include "test.h"
+
+/*
+in process fuzzing: t_fuzz calls the target run(p, n) in a loop with
+inputs made by random mutations of a corpus, p[n] is always 0 so text
+targets can use the input as a string. run returns a value summarizing
+what the call did (return value, errno, consumed length, output size..).
+
+libc is not built with coverage instrumentation, so this behaviour value
+stands in for coverage: an input producing a value not seen before is
+added to the corpus and is mutated further.
+
+the target checks its oracles with t_error, crashes (SIGSEGV, SIGBUS,
+SIGFPE, SIGILL, SIGABRT) are caught and an input running for more than
+HANG seconds is a hang. failures are told apart by their signature: the
+t_error call site of an oracle mismatch or the signal of a crash. the
+first input of each signature is saved as a regression test named
+fuzz-target-signature.c into $T_FUZZOUT, or src/regression if that
+exists, or the current directory, so one bug found by many inputs gives
+one test. the test defines T_FUZZREPRO and includes the target source
+from ../fuzz/ so it runs the same checks on that one input, targets do
+their setup lazily in run for this reason.
+
+the fuzzer runs for -t seconds (10 by default, at most until the runtest
+deadline) or for -n inputs, -s sets the random seed, it stops at MAXFAIL
+failures or at the first crash or hang. file arguments are run once each
+instead of fuzzing.
+*/
+
+#define TIME 10.0
+#define MARGIN 1.0
+enum {NCORPUS = 4096, NBIT = 1<<16, MAXLEN = 4096, MAXFAIL = 8, HANG = 3};
+
+static const struct t_fuzz *fz;
+static struct t_rand rng;
+static struct {
+	unsigned char *p;
+	size_t n;
+} corpus[NCORPUS];
+static size_t ncorpus;
+static unsigned char seen[NBIT/8];
+static size_t ndict;
+
+/* the input being run, for the signal handlers */
+static unsigned char input[MAXLEN+1];
+static volatile size_t inputlen;
+static volatile int running;
+static volatile unsigned long execs;
+
+/* signatures of the saved failures */
+static uint32_t saved[MAXFAIL];
+static size_t nsaved;
+
+static char outdir[256];
+static char path[512];
+static char text[8*MAXLEN];
+static size_t textlen;
+static char altstack[1<<16];
+
+/* bytes that tend to matter to parsers */
+static const char special[] = "\0\1\t\n 0123456789+-.eExXpPinfa/\\*?[]!^(){}|%$:,;'\"\177\200\377";
+
+static double now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec*1e-9;
+}
+
+static size_t rnd(size_t n)
+{
+	return t_rand64_r(&rng) % n;
+}
+
+/* output formatting without stdio, save runs in signal handlers */
+static void put(const char *s, size_t n)
+{
+	if (n > sizeof text - textlen)
+		n = sizeof text - textlen;
+	memcpy(text + textlen, s, n);
+	textlen += n;
+}
+
+static void putstr(const char *s)
+{
+	put(s, strlen(s));
+}
+
+static void putdec(unsigned long v)
+{
+	char b[24];
+	int i = sizeof b;
+
+	do b[--i] = '0' + v%10; while (v /= 10);
+	put(b + i, sizeof b - i);
+}
+
+static void puthex(unsigned long v, int w)
+{
+	char b[16];
+	int i;
+
+	for (i = w; i--; v >>= 4)
+		b[i] = "0123456789abcdef"[v & 15];
+	put(b, w);
+}
+
+/* the failure signature: the kind, the signal and the t_error format */
+static uint32_t signature(const char *kind, int sig, const char *fmt)
+{
+	uint32_t h = 2166136261u;
+
+	for (; *kind; kind++)
+		h = (h ^ (unsigned char)*kind) * 16777619;
+	h = (h ^ sig) * 16777619;
+	for (; fmt && *fmt; fmt++)
+		h = (h ^ (unsigned char)*fmt) * 16777619;
+	return h;
+}
+
+/* write the current input as a regression test and report it, unless a
+failure with the same signature was saved already */
+static void save(const char *kind, int sig, const char *fmt)
+{
+	const char *base = strrchr(fz->file, '/');
+	size_t n = inputlen, i, col;
+	uint32_t h = signature(kind, sig, fmt);
+	unsigned char c;
+	char e[4];
+	int fd;
+
+	for (i = 0; i < nsaved; i++)
+		if (saved[i] == h)
+			return;
+	if (nsaved < MAXFAIL)
+		saved[nsaved++] = h;
+	base = base ? base + 1 : fz->file;
+	textlen = 0;
+	putstr(outdir);
+	putstr("/fuzz-");
+	put(base, strcspn(base, "."));
+	putstr("-");
+	puthex(h, 8);
+	putstr(".c");
+	put("", 1);
+	if (textlen > sizeof path)
+		return;
+	memcpy(path, text, textlen);
+
+	textlen = 0;
+	putstr("// ");
+	put(base, strcspn(base, "."));
+	putstr(": ");
+	putstr(kind);
+	if (sig) {
+		putstr(" (signal ");
+		putdec(sig);
+		putstr(")");
+	}
+	putstr(", input found by fuzzing with ");
+	putstr(fz->file);
+	putstr("\n#define T_FUZZREPRO\n#include \"../fuzz/");
+	putstr(base);
+	putstr("\"\n\nint main(void)\n{\n\tstatic const unsigned char s[] =\n\t\t\"");
+	for (i = col = 0; i < n; i++) {
+		if (col >= 64) {
+			putstr("\"\n\t\t\"");
+			col = 0;
+		}
+		c = input[i];
+		/* octal escapes always have 3 digits, ? would start trigraphs */
+		if (c >= ' ' && c < 127 && c != '"' && c != '\\' && c != '?') {
+			put((char *)&c, 1);
+			col++;
+		} else {
+			e[0] = '\\';
+			e[1] = '0' + (c >> 6);
+			e[2] = '0' + (c >> 3 & 7);
+			e[3] = '0' + (c & 7);
+			put(e, 4);
+			col += 4;
+		}
+	}
+	putstr("\";\n\n\trun(s, sizeof s - 1);\n\treturn t_status;\n}\n");
+	fd = open(path, O_WRONLY|O_CREAT|O_EXCL, 0644);
+	if (fd >= 0) {
+		write(fd, text, textlen);
+		close(fd);
+	}
+
+	textlen = 0;
+	putstr(fz->file);
+	putstr(": ");
+	putstr(kind);
+	putstr(", input saved as ");
+	putstr(path);
+	putstr("\n");
+	write(1, text, textlen);
+}
+
+static void crash(int sig)
+{
+	if (running)
+		save("crash", sig, 0);
+	signal(sig, SIG_DFL);
+	raise(sig);
+}
+
+/* once a second: fail if the same input is still running */
+static void tick(int sig)
+{
+	static unsigned long last;
+	static int n;
+
+	if (!running || execs != last) {
+		last = execs;
+		n = 0;
+		return;
+	}
+	if (++n < HANG)
+		return;
+	save("hang", 0, 0);
+	_exit(1);
+}
+
+static void handlers(void)
+{
+	static const int sig[] = {SIGSEGV, SIGBUS, SIGFPE, SIGILL, SIGABRT};
+	struct sigaction sa = {.sa_flags = SA_ONSTACK|SA_RESTART};
+	struct itimerval it = {{1, 0}, {1, 0}};
+	stack_t ss = {.ss_sp = altstack, .ss_size = sizeof altstack};
+	int i;
+
+	sigaltstack(&ss, 0);
+	sigemptyset(&sa.sa_mask);
+	sa.sa_handler = crash;
+	for (i = 0; i < sizeof sig / sizeof *sig; i++)
+		sigaction(sig[i], &sa, 0);
+	sa.sa_handler = tick;
+	sigaction(SIGALRM, &sa, 0);
+	setitimer(ITIMER_REAL, &it, 0);
+}
+
+static void setoutdir(void)
+{
+	struct stat st;
+	char *s = getenv("T_FUZZOUT");
+
+	if (!s || !*s)
+		s = stat("src/regression", &st) == 0 && S_ISDIR(st.st_mode) ? "src/regression" : ".";
+	snprintf(outdir, sizeof outdir, "%s", s);
+}
+
+/* run the current input, returns 1 on an oracle failure */
+static int exec(unsigned long *v)
+{
+	input[inputlen] = 0;
+	execs++;
+	running = 1;
+	*v = fz->run(input, inputlen);
+	running = 0;
+	if (t_status) {
+		save("oracle mismatch", 0, t_lastfmt);
+		t_status = 0;
+		return 1;
+	}
+	return 0;
+}
+
+/* mark the behaviour seen, returns 1 if it is new */
+static int feature(unsigned long v)
+{
+	uint64_t h = (v ^ 0x5bd1e995) * 0x9e3779b97f4a7c15ULL;
+	size_t i = h >> 48;
+
+	if (seen[i/8] & 1 << i%8)
+		return 0;
+	seen[i/8] |= 1 << i%8;
+	return 1;
+}
+
+static void add(void)
+{
+	size_t i = ncorpus < NCORPUS ? ncorpus++ : rnd(NCORPUS);
+	unsigned char *p = malloc(inputlen + 1);
+
+	if (!p)
+		return;
+	memcpy(p, input, inputlen);
+	free(corpus[i].p);
+	corpus[i].p = p;
+	corpus[i].n = inputlen;
+}
+
+static size_t mutate(unsigned char *p, size_t n, size_t max)
+{
+	const char *t;
+	size_t i, j, k;
+
+	switch (rnd(10)) {
+	case 0: /* flip a bit */
+		if (n)
+			p[rnd(n)] ^= 1 << rnd(8);
+		break;
+	case 1: /* random byte */
+		if (n)
+			p[rnd(n)] = rnd(256);
+		break;
+	case 2: /* special byte */
+		if (n)
+			p[rnd(n)] = special[rnd(sizeof special - 1)];
+		break;
+	case 3: /* insert a byte */
+		if (n >= max)
+			break;
+		i = rnd(n + 1);
+		memmove(p + i + 1, p + i, n - i);
+		p[i] = rnd(2) ? rnd(256) : special[rnd(sizeof special - 1)];
+		n++;
+		break;
+	case 4: /* erase a range */
+		if (!n)
+			break;
+		i = rnd(n);
+		k = 1 + rnd(n - i < 8 ? n - i : 8);
+		memmove(p + i, p + i + k, n - i - k);
+		n -= k;
+		break;
+	case 5: /* insert a token */
+	case 6: /* overwrite with a token */
+		if (!ndict)
+			break;
+		t = fz->dict[rnd(ndict)];
+		k = strlen(t);
+		i = rnd(n + 1);
+		if (rnd(2) && n + k <= max) {
+			memmove(p + i + k, p + i, n - i);
+			n += k;
+		} else if (i + k > n) {
+			if (i + k > max)
+				break;
+			n = i + k;
+		}
+		memcpy(p + i, t, k);
+		break;
+	case 7: /* duplicate a range */
+		if (!n)
+			break;
+		i = rnd(n);
+		k = 1 + rnd(n - i);
+		if (n + k > max)
+			break;
+		j = rnd(n + 1);
+		memmove(p + j + k, p + j, n - j);
+		memmove(p + j, p + i + (i >= j ? k : 0), k);
+		n += k;
+		break;
+	case 8: /* splice with the tail of another input */
+		j = rnd(ncorpus);
+		i = rnd(n + 1);
+		k = rnd(corpus[j].n + 1);
+		if (i + corpus[j].n - k > max)
+			break;
+		memcpy(p + i, corpus[j].p + k, corpus[j].n - k);
+		n = i + corpus[j].n - k;
+		break;
+	case 9: /* small arithmetic */
+		if (n)
+			p[rnd(n)] += rnd(2) ? 1 : -1;
+		break;
+	}
+	return n;
+}
+
+static void runfile(const char *name)
+{
+	FILE *f = fopen(name, "rb");
+	unsigned long v;
+
+	if (!f) {
+		t_error("%s: cannot open\n", name);
+		return;
+	}
+	inputlen = fread(input, 1, fz->max < MAXLEN ? fz->max : MAXLEN, f);
+	fclose(f);
+	input[inputlen] = 0;
+	running = 1;
+	v = fz->run(input, inputlen);
+	running = 0;
+	printf("%s: %s: behaviour %#lx\n", fz->file, name, v);
+}
+
+int t_fuzz(const struct t_fuzz *z, int argc, char *argv[])
+{
+	double t0, end, limit = TIME;
+	unsigned long v, maxexecs = 0;
+	uint64_t seed = 1;
+	size_t max, i, k;
+	char *s;
+	int c, fails = 0;
+
+	fz = z;
+	max = z->max && z->max < MAXLEN ? z->max : MAXLEN;
+	while ((c = getopt(argc, argv, "n:s:t:")) != -1)
+		switch (c) {
+		case 'n': maxexecs = strtoul(optarg, 0, 0); break;
+		case 's': seed = strtoull(optarg, 0, 0); break;
+		case 't': limit = strtod(optarg, 0); break;
+		default:
+			t_error("usage: %s [-n execs] [-s seed] [-t seconds] [file...]\n", argv[0]);
+			return t_status;
+		}
+	if (t_status)
+		return t_status;
+	setoutdir();
+	handlers();
+	if (optind < argc) {
+		for (; optind < argc; optind++)
+			runfile(argv[optind]);
+		return t_status;
+	}
+
+	t_randseed_r(&rng, seed);
+	for (ndict = 0; z->dict && z->dict[ndict]; ndict++);
+	t0 = now();
+	end = t0 + limit;
+	if ((s = getenv("T_DEADLINE")) && strtod(s, 0) - MARGIN < end)
+		end = strtod(s, 0) - MARGIN;
+
+	/* the empty input and the seeds start the corpus */
+	inputlen = 0;
+	if (!exec(&v))
+		feature(v), add();
+	for (i = 0; z->seed && z->seed[i]; i++) {
+		inputlen = strlen(z->seed[i]);
+		if (inputlen > max)
+			inputlen = max;
+		memcpy(input, z->seed[i], inputlen);
+		if (exec(&v))
+			fails++;
+		else if (feature(v))
+			add();
+	}
+
+	while (fails < MAXFAIL && ncorpus) {
+		if ((execs & 15) == 0 && now() > end)
+			break;
+		if (maxexecs && execs >= maxexecs)
+			break;
+		i = rnd(ncorpus);
+		memcpy(input, corpus[i].p, corpus[i].n);
+		inputlen = corpus[i].n;
+		for (k = 1 + rnd(4); k; k--)
+			inputlen = mutate(input, inputlen, max);
+		if (exec(&v))
+			fails++;
+		else if (feature(v))
+			add();
+	}
+
+	t0 = now() - t0;
+	printf("%-24s %10lu execs in %4.1fs %10.0f/s corpus %4zu failures %d\n",
+		z->file, execs, t0, t0 > 0 ? execs / t0 : 0, ncorpus, fails);
+	if (fails)
+		t_status = 1;
+	return t_status;
+}
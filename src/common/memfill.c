@@ -7,14 +7,17 @@
 int t_memfill()
 {
 	int r = 0;
-	/* alloc mmap space with PROT_NONE */
-	if (t_vmfill(0,0,0) < 0) {
-		t_error("vmfill failed: %s\n", strerror(errno));
-		r = -1;
+	/* fail all further mmap and brk calls, or fill the memory if that is not supported */
+	if (t_allocfail(0, T_AFALL) < 0) {
+		/* alloc mmap space with PROT_NONE */
+		if (t_vmfill(0,0,0) < 0) {
+			t_error("vmfill failed: %s\n", strerror(errno));
+			r = -1;
+		}
+		/* limit brk space */
+		if (t_setrlim(RLIMIT_DATA, 0) < 0)
+			r = -1;
 	}
-	/* limit brk space */
-	if (t_setrlim(RLIMIT_DATA, 0) < 0)
-		r = -1;
 	if (!r)
 		/* use up libc reserves if any */
 		while (malloc(1));
@@ -1,7 +1,20 @@
 #include <stdio.h>
 #include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include "mtest.h"
 
+/* directory of the binary vector caches, set by the Makefile */
+#ifndef MCACHE
+#define MCACHE "."
+#endif
+
 int eulpf(float x)
 {
 	union { float f; uint32_t i; } u = { x };
@@ -142,3 +155,401 @@ char *rstr(int r)
 	}
 	return "R?";
 }
+
+#define M(s,k,m) {k, offsetof(struct s, m)}
+#define R(s) M(s,'r',r)
+#define E(s) M(s,'e',e)
+static const struct mtype {
+	char *name;
+	size_t size;
+	struct {char k; size_t off;} f[8];
+} mtype[] = {
+#define V(s,...) {#s, sizeof(struct s), {R(s), __VA_ARGS__, E(s)}},
+V(d_d, M(d_d,'d',x), M(d_d,'d',y), M(d_d,'f',dy))
+V(f_f, M(f_f,'f',x), M(f_f,'f',y), M(f_f,'f',dy))
+V(l_l, M(l_l,'l',x), M(l_l,'l',y), M(l_l,'f',dy))
+V(ff_f, M(ff_f,'f',x), M(ff_f,'f',x2), M(ff_f,'f',y), M(ff_f,'f',dy))
+V(dd_d, M(dd_d,'d',x), M(dd_d,'d',x2), M(dd_d,'d',y), M(dd_d,'f',dy))
+V(ll_l, M(ll_l,'l',x), M(ll_l,'l',x2), M(ll_l,'l',y), M(ll_l,'f',dy))
+V(d_di, M(d_di,'d',x), M(d_di,'d',y), M(d_di,'f',dy), M(d_di,'i',i))
+V(f_fi, M(f_fi,'f',x), M(f_fi,'f',y), M(f_fi,'f',dy), M(f_fi,'i',i))
+V(l_li, M(l_li,'l',x), M(l_li,'l',y), M(l_li,'f',dy), M(l_li,'i',i))
+V(di_d, M(di_d,'d',x), M(di_d,'i',i), M(di_d,'d',y), M(di_d,'f',dy))
+V(fi_f, M(fi_f,'f',x), M(fi_f,'i',i), M(fi_f,'f',y), M(fi_f,'f',dy))
+V(li_l, M(li_l,'l',x), M(li_l,'i',i), M(li_l,'l',y), M(li_l,'f',dy))
+V(d_i, M(d_i,'d',x), M(d_i,'i',i))
+V(f_i, M(f_i,'f',x), M(f_i,'i',i))
+V(l_i, M(l_i,'l',x), M(l_i,'i',i))
+V(d_dd, M(d_dd,'d',x), M(d_dd,'d',y), M(d_dd,'f',dy), M(d_dd,'d',y2), M(d_dd,'f',dy2))
+V(f_ff, M(f_ff,'f',x), M(f_ff,'f',y), M(f_ff,'f',dy), M(f_ff,'f',y2), M(f_ff,'f',dy2))
+V(l_ll, M(l_ll,'l',x), M(l_ll,'l',y), M(l_ll,'f',dy), M(l_ll,'l',y2), M(l_ll,'f',dy2))
+V(ff_fi, M(ff_fi,'f',x), M(ff_fi,'f',x2), M(ff_fi,'f',y), M(ff_fi,'f',dy), M(ff_fi,'i',i))
+V(dd_di, M(dd_di,'d',x), M(dd_di,'d',x2), M(dd_di,'d',y), M(dd_di,'f',dy), M(dd_di,'i',i))
+V(ll_li, M(ll_li,'l',x), M(ll_li,'l',x2), M(ll_li,'l',y), M(ll_li,'f',dy), M(ll_li,'i',i))
+V(fff_f, M(fff_f,'f',x), M(fff_f,'f',x2), M(fff_f,'f',x3), M(fff_f,'f',y), M(fff_f,'f',dy))
+V(ddd_d, M(ddd_d,'d',x), M(ddd_d,'d',x2), M(ddd_d,'d',x3), M(ddd_d,'d',y), M(ddd_d,'f',dy))
+V(lll_l, M(lll_l,'l',x), M(lll_l,'l',x2), M(lll_l,'l',x3), M(lll_l,'l',y), M(lll_l,'f',dy))
+#undef V
+};
+#undef M
+#undef R
+#undef E
+
+/* the cache file header, records start at offset sizeof(struct mhdr) */
+struct mhdr {
+	char magic[8];
+	char type[8];
+	uint32_t size;
+	uint32_t mant;
+	uint64_t n;
+	char pad[32];
+};
+
+static const char mmagic[8] = "mtest\1\2\4";
+
+static struct {char *s; int v;} rname[] = {{"RN",RN}, {"RZ",RZ}, {"RD",RD}, {"RU",RU}};
+
+static int parsef(const struct mtype *m, char *rec, int line, char *s)
+{
+	static struct {char *s; int v;} iname[] = {{"FP_ILOGB0",FP_ILOGB0}, {"FP_ILOGBNAN",FP_ILOGBNAN}, {"-1U/2",INT_MAX}};
+	char *e;
+	int i, j, v;
+
+	*(int *)(rec + offsetof(struct d_d, line)) = line;
+	for (i = 0; m->f[i].k; i++) {
+		char *p = rec + m->f[i].off;
+
+		while (*s == ' ' || *s == '\t')
+			s++;
+		switch (m->f[i].k) {
+		case 'r':
+			for (j = 0; j < length(rname); j++)
+				if (strncmp(s, rname[j].s, 2) == 0)
+					break;
+			if (j == length(rname))
+				return -1;
+			*(int *)p = rname[j].v;
+			e = s + 2;
+			break;
+		case 'e':
+			for (v = 0, e = s; ; e++) {
+				while (*e == ' ' || *e == '\t')
+					e++;
+				for (j = 0; j < length(eflags); j++)
+					if (strncmp(e, eflags[j].s, strlen(eflags[j].s)) == 0)
+						break;
+				if (j < length(eflags)) {
+					v |= eflags[j].flag;
+					e += strlen(eflags[j].s);
+				} else {
+					v |= strtol(s = e, &e, 0);
+					if (e == s)
+						return -1;
+				}
+				while (*e == ' ' || *e == '\t')
+					e++;
+				if (*e != '|')
+					break;
+			}
+			*(int *)p = v;
+			break;
+		case 'f':
+			*(float *)p = strtof(s, &e);
+			break;
+		case 'd':
+			*(double *)p = strtod(s, &e);
+			break;
+		case 'l':
+			*(long double *)p = strtold(s, &e);
+			if (*e == 'L')
+				e++;
+			break;
+		case 'i':
+			for (j = 0; j < length(iname); j++)
+				if (strncmp(s, iname[j].s, strlen(iname[j].s)) == 0)
+					break;
+			if (j < length(iname)) {
+				*(long long *)p = iname[j].v;
+				e = s + strlen(iname[j].s);
+				break;
+			}
+			*(long long *)p = strtoll(s, &e, 0);
+			while (*e == 'L' || *e == 'l')
+				e++;
+			break;
+		}
+		if (e == s)
+			return -1;
+		while (*e == ' ' || *e == '\t')
+			e++;
+		if (*e != (m->f[i+1].k ? ',' : ')'))
+			return -1;
+		s = e + 1;
+	}
+	return 0;
+}
+
+static int rkey(const char *rec)
+{
+	int r = *(const int *)(rec + offsetof(struct d_d, r));
+	int i;
+
+	for (i = 0; i < length(rname); i++)
+		if (rname[i].v == r)
+			break;
+	return i;
+}
+
+/*
+stable partition of the records by rounding mode (RN first), so a test
+changes the rounding mode a few times per file instead of per record
+*/
+static int group(const struct mtype *m, char *rec, size_t n)
+{
+	char *tmp, *q;
+	size_t i;
+	int k;
+
+	tmp = malloc(n * m->size);
+	if (!tmp)
+		return -1;
+	q = tmp;
+	for (k = 0; k <= length(rname); k++)
+		for (i = 0; i < n; i++)
+			if (rkey(rec + i * m->size) == k) {
+				memcpy(q, rec + i * m->size, m->size);
+				q += m->size;
+			}
+	memcpy(rec, tmp, n * m->size);
+	free(tmp);
+	return 0;
+}
+
+/* convert the T(...) lines of file into a header and records in malloced memory */
+static void *conv(const struct mtype *m, const char *file, size_t *len)
+{
+	struct mhdr *h;
+	FILE *f;
+	char *buf = 0, *p;
+	size_t cap = 0, n = 0, sz = 0;
+	int line = 0, r;
+
+	f = fopen(file, "r");
+	if (!f) {
+		printf("%s: cannot open: %s\n", file, strerror(errno));
+		return 0;
+	}
+	cap = sizeof *h + 1024 * m->size;
+	p = malloc(cap);
+	/* the tables are exact in any rounding mode but be safe */
+	r = fegetround();
+	fesetround(RN);
+	while (p && getline(&buf, &sz, f) > 0) {
+		line++;
+		if (strncmp(buf, "T(", 2) != 0)
+			continue;
+		if (sizeof *h + (n+1) * m->size > cap) {
+			char *q = realloc(p, cap *= 2);
+			if (!q) {
+				free(p);
+				p = 0;
+				break;
+			}
+			p = q;
+		}
+		memset(p + sizeof *h + n * m->size, 0, m->size);
+		if (parsef(m, p + sizeof *h + n * m->size, line, buf + 2)) {
+			printf("%s:%d: cannot parse %s vector\n", file, line, m->name);
+			free(p);
+			p = 0;
+			break;
+		}
+		n++;
+	}
+	fesetround(r);
+	free(buf);
+	fclose(f);
+	if (p && group(m, p + sizeof *h, n)) {
+		free(p);
+		p = 0;
+	}
+	if (!p)
+		return 0;
+	h = (struct mhdr *)p;
+	memset(h, 0, sizeof *h);
+	memcpy(h->magic, mmagic, sizeof h->magic);
+	snprintf(h->type, sizeof h->type, "%s", m->name);
+	h->size = m->size;
+	h->mant = LDBL_MANT_DIG;
+	h->n = n;
+	*len = sizeof *h + n * m->size;
+	return p;
+}
+
+static int valid(const struct mtype *m, const struct mhdr *h, size_t len)
+{
+	return len >= sizeof *h && memcmp(h->magic, mmagic, sizeof h->magic) == 0 &&
+		strncmp(h->type, m->name, sizeof h->type) == 0 && h->size == m->size &&
+		h->mant == LDBL_MANT_DIG && h->n == (len - sizeof *h) / m->size &&
+		len == sizeof *h + h->n * m->size;
+}
+
+static int newer(const struct stat *a, const struct stat *b)
+{
+	if (a->st_mtim.tv_sec != b->st_mtim.tv_sec)
+		return a->st_mtim.tv_sec > b->st_mtim.tv_sec;
+	return a->st_mtim.tv_nsec >= b->st_mtim.tv_nsec;
+}
+
+/* map name.type.bin, return -1 if it is missing, stale or invalid */
+static int mapcache(struct mvec *v, const struct mtype *m, const char *bin, const struct stat *src)
+{
+	struct stat st;
+	void *map;
+	int fd;
+
+	fd = open(bin, O_RDONLY);
+	if (fd < 0)
+		return -1;
+	if (fstat(fd, &st) || !newer(&st, src) || st.st_size < sizeof(struct mhdr)) {
+		close(fd);
+		return -1;
+	}
+	map = mmap(0, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (map == MAP_FAILED)
+		return -1;
+	if (!valid(m, map, st.st_size)) {
+		munmap(map, st.st_size);
+		return -1;
+	}
+	v->map = map;
+	v->maplen = st.st_size;
+	return 0;
+}
+
+/* write the cache atomically, failure is not an error (read only tree) */
+static void writecache(const char *bin, const void *p, size_t len)
+{
+	char tmp[PATH_MAX];
+	int fd;
+
+	mkdir(MCACHE, 0777);
+	if (snprintf(tmp, sizeof tmp, "%s.XXXXXX", bin) >= sizeof tmp)
+		return;
+	fd = mkstemp(tmp);
+	if (fd < 0)
+		return;
+	if (write(fd, p, len) != len || fchmod(fd, 0644) || close(fd) || rename(tmp, bin))
+		unlink(tmp);
+}
+
+int mvec_open(struct mvec *v, const char *type, size_t size, const char *file)
+{
+	const struct mtype *m;
+	struct stat st;
+	char bin[PATH_MAX], *q;
+	const char *dot;
+	void *p;
+	size_t len;
+	int i;
+
+	memset(v, 0, sizeof *v);
+	for (i = 0; i < length(mtype); i++)
+		if (strcmp(mtype[i].name, type) == 0)
+			break;
+	if (i == length(mtype) || mtype[i].size != size) {
+		printf("%s: bad vector type %s\n", file, type);
+		return -1;
+	}
+	m = mtype + i;
+	if (stat(file, &st)) {
+		printf("%s: cannot stat: %s\n", file, strerror(errno));
+		return -1;
+	}
+	/* the cache of dir/name.h is MCACHE/dir_name.type.bin */
+	dot = strrchr(file, '.');
+	if (!dot || strchr(dot, '/'))
+		dot = file + strlen(file);
+	if (snprintf(bin, sizeof bin, "%s/%.*s.%s.bin", MCACHE, (int)(dot - file), file, type) >= sizeof bin) {
+		printf("%s: path too long\n", file);
+		return -1;
+	}
+	for (q = bin + strlen(MCACHE) + 1; *q; q++)
+		if (*q == '/')
+			*q = '_';
+	if (mapcache(v, m, bin, &st)) {
+		p = conv(m, file, &len);
+		if (!p)
+			return -1;
+		writecache(bin, p, len);
+		if (mapcache(v, m, bin, &st)) {
+			/* use the converted table directly */
+			v->map = p;
+			v->maplen = 0;
+		} else
+			free(p);
+	}
+	v->file = (char *)file;
+	v->t = (char *)v->map + sizeof(struct mhdr);
+	v->n = ((struct mhdr *)v->map)->n;
+	return 0;
+}
+
+void mvec_close(struct mvec *v)
+{
+	if (v->maplen)
+		munmap(v->map, v->maplen);
+	else
+		free(v->map);
+	memset(v, 0, sizeof *v);
+}
+
+void minit(struct miter *it, const char *type, void *t, size_t n, size_t size, const char *src, char **vec)
+{
+	const char *s = strrchr(src, '/');
+	int k = s ? s - src + 1 : 0;
+
+	memset(it, 0, sizeof *it);
+	it->type = type;
+	it->size = size;
+	it->t = t;
+	it->n = n;
+	it->vec = vec;
+	if (k >= sizeof it->dir || size > sizeof it->buf) {
+		printf("%s: bad vector iterator\n", src);
+		it->err = 1;
+		it->n = 0;
+		it->vec = 0;
+		return;
+	}
+	memcpy(it->dir, src, k);
+}
+
+void *mnext(struct miter *it)
+{
+	for (;;) {
+		if (it->i < it->n) {
+			char *p = (char *)it->t + it->i++ * it->size;
+
+			if (!it->v.map)
+				return p;
+			/* records in the map are read only and have no file name */
+			memcpy(it->buf.c, p, it->size);
+			memcpy(it->buf.c, &it->v.file, sizeof it->v.file);
+			return it->buf.c;
+		}
+		if (it->v.map)
+			mvec_close(&it->v);
+		if (!it->vec || !*it->vec)
+			return 0;
+		it->i = it->n = 0;
+		if (snprintf(it->file, sizeof it->file, "%s%s", it->dir, *it->vec++) >= sizeof it->file ||
+		    mvec_open(&it->v, it->type, it->size, it->file)) {
+			it->err++;
+			continue;
+		}
+		it->t = it->v.t;
+		it->n = it->v.n;
+	}
+}
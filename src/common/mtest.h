@@ -1,3 +1,5 @@
+#include <stddef.h>
+#include <stdio.h>
 #include <fenv.h>
 #include <float.h>
 #include <math.h>
@@ -92,6 +94,46 @@ struct ddd_d {POS int r; double x; double x2; double x3; double y; float dy; int
 struct lll_l {POS int r; long double x; long double x2; long double x3; long double y; float dy; int e; };
 #undef POS
 
+/*
+binary test vectors: a T(...) header is converted into records of the
+given struct type (native layout, file is 0, line is the header line,
+grouped by rounding mode) after a small header, the result is cached
+in the build directory as MCACHE/dir_name.type.bin (MCACHE is
+$(B)/math/cache) and mmapped, so large tables need not be compiled in.
+the cache is regenerated when it is older than the header.
+*/
+struct mvec {
+	char *file;
+	void *t;
+	size_t n;
+	void *map;
+	size_t maplen;
+};
+
+int mvec_open(struct mvec *, const char *type, size_t size, const char *file);
+void mvec_close(struct mvec *);
+
+/* iterates over the static table t then over the mapped vector files */
+struct miter {
+	const char *type;
+	size_t size;
+	char dir[256];
+	char file[512];
+	char **vec;
+	struct mvec v;
+	void *t;
+	size_t n;
+	size_t i;
+	int err;
+	union {long double l; long long i; void *p; char c[192];} buf;
+};
+
+/* vec is a 0 terminated list of headers relative to the directory of src */
+void minit(struct miter *, const char *type, void *t, size_t n, size_t size, const char *src, char **vec);
+void *mnext(struct miter *);
+
+#include "ustat.h"
+
 char *estr(int);
 char *rstr(int);
 
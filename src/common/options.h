@@ -0,0 +1,25 @@
+#define POSIX_ADVISORY_INFO 200809L
+#define POSIX_CPUTIME 0
+#define POSIX_FSYNC 200809L
+#define POSIX_IPV6 200809L
+#define POSIX_MEMLOCK 200809L
+#define POSIX_MEMLOCK_RANGE 200809L
+#define POSIX_MESSAGE_PASSING 200809L
+#define POSIX_MONOTONIC_CLOCK 0
+#define POSIX_PRIORITIZED_IO 200809L
+#define POSIX_PRIORITY_SCHEDULING 200809L
+#define POSIX_RAW_SOCKETS 200809L
+#define POSIX_SHARED_MEMORY_OBJECTS 200809L
+#define POSIX_SPAWN 200809L
+#define POSIX_SYNCHRONIZED_IO 200809L
+#define POSIX_THREAD_ATTR_STACKADDR 200809L
+#define POSIX_THREAD_ATTR_STACKSIZE 200809L
+#define POSIX_THREAD_CPUTIME 0
+#define POSIX_THREAD_PRIO_INHERIT 200809L
+#define POSIX_THREAD_PRIO_PROTECT 200809L
+#define POSIX_THREAD_PRIORITY_SCHEDULING 200809L
+#define POSIX_THREAD_PROCESS_SHARED 200809L
+#define POSIX_THREAD_ROBUST_PRIO_INHERIT 200809L
+#define XOPEN_REALTIME 1
+#define XOPEN_REALTIME_THREADS 1
+#define XOPEN_UNIX 1
@@ -1,28 +1,101 @@
 #include <stdio.h>
 #include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <fcntl.h>
 #include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
 #include "test.h"
+#ifndef MAP_ANONYMOUS
+	#define MAP_ANONYMOUS 0
+#endif
+#ifndef PIPE_BUF
+	#define PIPE_BUF 512
+#endif
 
-volatile int t_status = 0;
+/*
+the status is kept in a shared mapping made before main, so failures in
+forked children are seen by the parent, it is only ever set to 1 so the
+atomic or aggregates the status of all threads and processes.
+
+a message is written with one write (at most PIPE_BUF bytes) so messages
+of concurrent threads and processes do not interleave, a message without
+a final newline is kept in a per thread buffer and written together with
+the rest of its line, or when the thread exits, forks or calls exit.
+*/
+
+static volatile int status0;
+volatile int *t_statusp = &status0;
+const char *t_lastfmt;
+
+static __thread char line[PIPE_BUF];
+static __thread size_t linelen;
+static pthread_key_t key;
+
+/* end the pending line so it does not run into other output */
+static void flush(void)
+{
+	if (linelen) {
+		line[linelen++] = '\n';
+		write(1, line, linelen);
+		linelen = 0;
+	}
+}
+
+static void flushkey(void *p)
+{
+	flush();
+}
+
+__attribute__((constructor))
+static void init(void)
+{
+	int fd = MAP_ANONYMOUS ? -1 : open("/dev/zero", O_RDWR);
+	void *p = mmap(0, sizeof *t_statusp, PROT_READ|PROT_WRITE, MAP_SHARED|MAP_ANONYMOUS, fd, 0);
+
+	if (p != MAP_FAILED)
+		t_statusp = p;
+	if (fd >= 0)
+		close(fd);
+	/* the key is set by each thread that buffers, its destructor flushes */
+	pthread_key_create(&key, flushkey);
+	pthread_atfork(flush, 0, 0);
+	atexit(flush);
+}
 
 int t_printf(const char *s, ...)
 {
 	va_list ap;
-	char buf[512];
-	int n;
+	char buf[PIPE_BUF];
+	size_t n;
+	int r;
 
-	t_status = 1;
+	__sync_fetch_and_or(t_statusp, 1);
+	t_lastfmt = s;
 	va_start(ap, s);
-	n = vsnprintf(buf, sizeof buf, s, ap);
+	r = vsnprintf(buf + linelen, sizeof buf - linelen, s, ap);
 	va_end(ap);
-	if (n < 0)
-		n = 0;
-	else if (n >= sizeof buf) {
+	if (r < 0)
+		r = 0;
+	n = linelen + r;
+	if (n == 0)
+		return 0;
+	if (n >= sizeof buf) {
 		n = sizeof buf;
 		buf[n - 1] = '\n';
 		buf[n - 2] = '.';
 		buf[n - 3] = '.';
 		buf[n - 4] = '.';
 	}
+	memcpy(buf, line, linelen);
+	linelen = 0;
+	if (buf[n-1] != '\n' && n < sizeof buf) {
+		memcpy(line, buf, n);
+		linelen = n;
+		pthread_setspecific(key, line);
+		return r;
+	}
 	return write(1, buf, n);
 }
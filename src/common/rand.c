@@ -1,70 +1,125 @@
-#include <float.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include "test.h"
 
-// TODO: use large period prng
-static uint64_t seed = -1;
-static uint32_t rand32(void)
+/*
+xoshiro256** with splitmix64 seeding: period 2^256-1, a state can be
+jumped ahead by 2^128 steps, so parallel users get non-overlapping
+reproducible streams from one seed without locking (t_randstream).
+the t_*_r functions use an explicit state, the others a global one.
+*/
+
+/* t_randseed(-1) */
+static struct t_rand g = {{
+	0xe4d971771b652c20ULL, 0xe99ff867dbf682c9ULL,
+	0x382ff84cb27281e9ULL, 0x6d1db36ccba982d2ULL}};
+
+static uint64_t rotl(uint64_t x, int k)
 {
-	seed = 6364136223846793005ULL*seed + 1;
-	return seed >> 32;
+	return x << k | x >> (64 - k);
 }
-static uint64_t rand64(void)
+
+uint64_t t_rand64_r(struct t_rand *r)
 {
-	uint64_t u = rand32();
-	return u<<32 | rand32();
+	uint64_t *s = r->s;
+	uint64_t x = rotl(s[1] * 5, 7) * 9;
+	uint64_t t = s[1] << 17;
+
+	s[2] ^= s[0];
+	s[3] ^= s[1];
+	s[1] ^= s[2];
+	s[0] ^= s[3];
+	s[2] ^= t;
+	s[3] = rotl(s[3], 45);
+	return x;
 }
-static double frand()
+
+void t_randseed_r(struct t_rand *r, uint64_t seed)
 {
-	return rand64() * 0x1p-64;
+	uint64_t z;
+	int i;
+
+	/* splitmix64, never gives the all zero state */
+	for (i = 0; i < 4; i++) {
+		z = seed += 0x9e3779b97f4a7c15ULL;
+		z = (z ^ z>>30) * 0xbf58476d1ce4e5b9ULL;
+		z = (z ^ z>>27) * 0x94d049bb133111ebULL;
+		r->s[i] = z ^ z>>31;
+	}
 }
-static float frandf()
+
+/* advance r by 2^128 steps */
+void t_randjump_r(struct t_rand *r)
 {
-	return rand32() * 0x1p-32f;
+	static const uint64_t jump[] = {
+		0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL,
+		0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL};
+	uint64_t t[4] = {0};
+	int i, b, k;
+
+	for (i = 0; i < 4; i++)
+		for (b = 0; b < 64; b++) {
+			if (jump[i] >> b & 1)
+				for (k = 0; k < 4; k++)
+					t[k] ^= r->s[k];
+			t_rand64_r(r);
+		}
+	for (k = 0; k < 4; k++)
+		r->s[k] = t[k];
 }
-static long double frandl()
+
+/* stream i of seed: independent of the other streams for 2^128 draws */
+void t_randstream(struct t_rand *r, uint64_t seed, uint64_t i)
 {
-	return rand64() * 0x1p-64L
-#if LDBL_MANT_DIG > 64
-+ rand64() * 0x1p-128L
-#endif
-;
+	t_randseed_r(r, seed);
+	while (i--)
+		t_randjump_r(r);
 }
 
 void t_randseed(uint64_t s)
 {
-	seed = s;
+	t_randseed_r(&g, s);
 }
 
 /* uniform random in [0,n), n > 0 must hold */
-uint64_t t_randn(uint64_t n)
+uint64_t t_randn_r(struct t_rand *r, uint64_t n)
 {
-	uint64_t r, m;
+	uint64_t x, m;
 
 	/* m is the largest multiple of n */
 	m = -1;
 	m -= m%n;
-	while ((r = rand64()) >= m);
-	return r%n;
+	while ((x = t_rand64_r(r)) >= m);
+	return x%n;
 }
 
 /* uniform on [a,b], a <= b must hold */
-uint64_t t_randint(uint64_t a, uint64_t b)
+uint64_t t_randint_r(struct t_rand *r, uint64_t a, uint64_t b)
 {
 	uint64_t n = b - a + 1;
 	if (n)
-		return a + t_randn(n);
-	return rand64();
+		return a + t_randn_r(r, n);
+	return t_rand64_r(r);
+}
+
+uint64_t t_randn(uint64_t n)
+{
+	return t_randn_r(&g, n);
+}
+
+uint64_t t_randint(uint64_t a, uint64_t b)
+{
+	return t_randint_r(&g, a, b);
 }
 
 /* shuffle the elements of p and q until the elements in p are well shuffled */
-static void shuffle2(uint64_t *p, uint64_t *q, size_t np, size_t nq)
+static void shuffle2(struct t_rand *rnd, uint64_t *p, uint64_t *q, size_t np, size_t nq)
 {
 	size_t r;
 	uint64_t t;
 
 	while (np) {
-		r = t_randn(nq+np--);
+		r = t_randn_r(rnd, nq+np--);
 		t = p[np];
 		if (r < nq) {
 			p[np] = q[r];
@@ -77,17 +132,27 @@ static void shuffle2(uint64_t *p, uint64_t *q, size_t np, size_t nq)
 }
 
 /* shuffle the elements of p */
-void t_shuffle(uint64_t *p, size_t n)
+void t_shuffle_r(struct t_rand *r, uint64_t *p, size_t n)
 {
-	shuffle2(p,0,n,0);
+	shuffle2(r,p,0,n,0);
 }
 
-void t_randrange(uint64_t *p, size_t n)
+void t_randrange_r(struct t_rand *r, uint64_t *p, size_t n)
 {
 	size_t i;
 	for (i = 0; i < n; i++)
 		p[i] = i;
-	t_shuffle(p, n);
+	t_shuffle_r(r, p, n);
+}
+
+void t_shuffle(uint64_t *p, size_t n)
+{
+	t_shuffle_r(&g, p, n);
+}
+
+void t_randrange(uint64_t *p, size_t n)
+{
+	t_randrange_r(&g, p, n);
 }
 
 /* hash table insert, 0 means empty, v > 0 must hold, len is power-of-2 */
@@ -107,7 +172,7 @@ static int insert(uint64_t *tab, size_t len, uint64_t v)
 }
 
 /* choose k unique numbers from [0,n), k <= n */
-int t_choose(uint64_t n, size_t k, uint64_t *p)
+int t_choose_r(struct t_rand *r, uint64_t n, size_t k, uint64_t *p)
 {
 	uint64_t *tab;
 	size_t i, j, len;
@@ -118,7 +183,7 @@ int t_choose(uint64_t n, size_t k, uint64_t *p)
 	if (n < 16) {
 		/* no alloc */
 		while (k)
-			if (t_randn(n--) < k)
+			if (t_randn_r(r, n--) < k)
 				p[--k] = n;
 		return 0;
 	}
@@ -126,7 +191,7 @@ int t_choose(uint64_t n, size_t k, uint64_t *p)
 	if (k < 8) {
 		/* no alloc, n > 15 > 2*k */
 		for (i = 0; i < k;) {
-			p[i] = t_randn(n);
+			p[i] = t_randn_r(r, n);
 			for (j = 0; p[j] != p[i]; j++);
 			if (j == i)
 				i++;
@@ -146,9 +211,9 @@ int t_choose(uint64_t n, size_t k, uint64_t *p)
 		for (; i < n; i++)
 			tab[i-k] = i;
 		if (k < n-k)
-			shuffle2(p, tab, k, n-k);
+			shuffle2(r, p, tab, k, n-k);
 		else
-			shuffle2(tab, p, n-k, k);
+			shuffle2(r, tab, p, n-k, k);
 		free(tab);
 		return 0;
 	}
@@ -159,7 +224,7 @@ int t_choose(uint64_t n, size_t k, uint64_t *p)
 	if (!tab)
 		return -1;
 	for (i = 0; i < k; i++)
-		while (insert(tab, len, t_randn(n)+1));
+		while (insert(tab, len, t_randn_r(r, n)+1));
 	for (i = 0; i < len; i++)
 		if (tab[i])
 			*p++ = tab[i]-1;
@@ -167,3 +232,7 @@ int t_choose(uint64_t n, size_t k, uint64_t *p)
 	return 0;
 }
 
+int t_choose(uint64_t n, size_t k, uint64_t *p)
+{
+	return t_choose_r(&g, n, k, p);
+}
@@ -0,0 +1,229 @@
+#include <float.h>
+#include <math.h>
+#include <stdint.h>
+#include "test.h"
+
+/*
+floating-point samplers on [a,b] (finite, a <= b)
+
+T_FULP: every representable value is equally likely (ulp uniform), so
+        each binade gets the same share and subnormals are reached
+T_FEXP: the binary exponent is uniform (subnormal exponents count too),
+        a binade partly outside [a,b] by its share inside, then the
+        value is ulp uniform within that binade
+T_FNEAR: a few ulps around an integer or a halfway point n+0.5 near an
+        exponent stratified sample, where rounding is hardest
+T_FSUB: subnormals and the smallest normals, the boundary values between
+        them are picked often
+
+the values are generated in long double using the precision and exponent
+range of the target type, so they are exact in the target type.
+*/
+
+struct fmt {
+	int p;      /* significand bits */
+	int emin;   /* exponent of the smallest normal */
+	long double max;
+};
+
+static const struct fmt ff = {FLT_MANT_DIG, FLT_MIN_EXP-1, FLT_MAX};
+static const struct fmt fd = {DBL_MANT_DIG, DBL_MIN_EXP-1, DBL_MAX};
+static const struct fmt fl = {LDBL_MANT_DIG, LDBL_MIN_EXP-1, LDBL_MAX};
+
+/* uniform in [0,1) */
+static long double unif(struct t_rand *r)
+{
+	return t_rand64_r(r) * 0x1p-64L
+#if LDBL_MANT_DIG > 64
++ t_rand64_r(r) * 0x1p-128L
+#endif
+;
+}
+
+/* uniform integer in [a,b], both exact integers */
+static long double unifint(struct t_rand *r, long double a, long double b)
+{
+	long double x = a + floorl(unif(r) * (b - a + 1));
+	return x > b ? b : x;
+}
+
+/* x >= 0 as binade h (0 is subnormal) and significand index l < 2^(p-1) */
+static void idx(const struct fmt *f, long double x, long *h, long double *l)
+{
+	int e;
+
+	if (x < ldexpl(1, f->emin)) {
+		*h = 0;
+		*l = ldexpl(x, f->p - 1 - f->emin);
+		return;
+	}
+	e = ilogbl(x);
+	*h = e - f->emin + 1;
+	*l = ldexpl(x, f->p - 1 - e) - ldexpl(1, f->p - 1);
+}
+
+static long double val(const struct fmt *f, long h, long double l)
+{
+	if (h == 0)
+		return ldexpl(l, f->emin - f->p + 1);
+	return ldexpl(ldexpl(1, f->p - 1) + l, f->emin + h - f->p);
+}
+
+/* spacing of the values at x in the target type */
+static long double ulp(const struct fmt *f, long double x)
+{
+	int e = x == 0 ? f->emin : ilogbl(x);
+
+	return ldexpl(1, (e < f->emin ? f->emin : e) - f->p + 1);
+}
+
+static long double ulpu(struct t_rand *r, const struct fmt *f, long double a, long double b)
+{
+	long ha, hb;
+	long double la, lb, n = ldexpl(1, f->p - 1), w1, w2, u;
+
+	idx(f, a, &ha, &la);
+	idx(f, b, &hb, &lb);
+	if (ha == hb)
+		return val(f, ha, unifint(r, la, lb));
+	/* partial binades at the ends, full ones between */
+	w1 = n - la;
+	w2 = lb + 1;
+	u = unif(r) * (w1 + w2 + (hb - ha - 1) * n);
+	if (u < w1)
+		return val(f, ha, unifint(r, la, n - 1));
+	if (u < w1 + w2 || hb - ha == 1)
+		return val(f, hb, unifint(r, 0, lb));
+	return val(f, ha + 1 + (long)t_randn_r(r, hb - ha - 1), unifint(r, 0, n - 1));
+}
+
+/* share of the values of binade e (x in [2^e, 2^(e+1))) that are in [a,b] */
+static long double share(const struct fmt *f, int e, long double a, long double b)
+{
+	long double lo = ldexpl(1, e), u = ulp(f, lo), hi = ldexpl(1, e + 1) - u;
+
+	if (a > lo)
+		lo = a;
+	if (b < hi)
+		hi = b;
+	return lo > hi ? 0 : ((hi - lo) / u + 1) / (ldexpl(1, e) / u);
+}
+
+/* the binades are weighted by their share in [a,b], so a partial one is less likely */
+static long double expu(struct t_rand *r, const struct fmt *f, long double a, long double b)
+{
+	int ea, eb, e;
+	long double lo, hi, w1, w2, u;
+
+	if (b == 0)
+		return 0;
+	ea = a > 0 ? ilogbl(a) : f->emin - f->p + 1;
+	eb = ilogbl(b);
+	e = ea;
+	if (ea != eb) {
+		w1 = share(f, ea, a, b);
+		w2 = share(f, eb, a, b);
+		u = unif(r) * (w1 + w2 + (eb - ea - 1));
+		if (u < w1)
+			e = ea;
+		else if (u < w1 + w2 || eb - ea == 1)
+			e = eb;
+		else
+			e = ea + 1 + (int)t_randn_r(r, eb - ea - 1);
+	}
+	lo = ldexpl(1, e);
+	hi = ldexpl(1, e + 1);
+	hi -= ulp(f, lo);
+	return ulpu(r, f, lo < a ? a : lo, hi > b ? b : hi);
+}
+
+static long double near(struct t_rand *r, const struct fmt *f, long double a, long double b)
+{
+	long double x;
+
+	/* below 1/4 the nearest integer or halfway point is mostly 0 */
+	x = expu(r, f, b >= 0.25 && a < 0.25 ? 0.25 : a, b);
+	if (x < ldexpl(1, f->p - 1))
+		x = t_randn_r(r, 2) ? roundl(x) : floorl(x) + 0.5;
+	x += ((long)t_randn_r(r, 9) - 4) * ulp(f, x);
+	return x < a ? a : x > b ? b : x;
+}
+
+static long double sub(struct t_rand *r, const struct fmt *f, long double a, long double b)
+{
+	long double tiny = ldexpl(1, f->emin), x;
+
+	if (a >= 2*tiny)
+		return ulpu(r, f, a, b);
+	if (t_randn_r(r, 4) == 0) {
+		/* smallest subnormal, largest subnormal, smallest normal */
+		switch (t_randn_r(r, 3)) {
+		case 0: x = ulp(f, 0); break;
+		case 1: x = tiny - ulp(f, 0); break;
+		default: x = tiny;
+		}
+		return x < a ? a : x > b ? b : x;
+	}
+	return ulpu(r, f, a, b < 2*tiny ? b : 2*tiny);
+}
+
+static long double pos(struct t_rand *r, const struct fmt *f, int mode, long double a, long double b)
+{
+	switch (mode) {
+	case T_FEXP: return expu(r, f, a, b);
+	case T_FNEAR: return near(r, f, a, b);
+	case T_FSUB: return sub(r, f, a, b);
+	}
+	return ulpu(r, f, a, b);
+}
+
+/* share of [0,x] in mode, to choose the sign when a < 0 < b */
+static long double weight(const struct fmt *f, int mode, long double x)
+{
+	long h;
+	long double l;
+
+	if (mode == T_FSUB)
+		return 1;
+	if (mode == T_FULP) {
+		idx(f, x, &h, &l);
+		return h * ldexpl(1, f->p - 1) + l + 1;
+	}
+	if (x == 0)
+		return 0;
+	return ilogbl(x) - (f->emin - f->p + 1) + share(f, ilogbl(x), 0, x);
+}
+
+static long double sample(struct t_rand *r, const struct fmt *f, int mode, long double a, long double b)
+{
+	long double wn, wp;
+
+	if (a < -f->max)
+		a = -f->max;
+	if (b > f->max)
+		b = f->max;
+	if (a >= 0)
+		return pos(r, f, mode, a, b);
+	if (b <= 0)
+		return -pos(r, f, mode, -b, -a);
+	wn = weight(f, mode, -a);
+	wp = weight(f, mode, b);
+	if (unif(r) * (wn + wp) < wn)
+		return -pos(r, f, mode, 0, -a);
+	return pos(r, f, mode, 0, b);
+}
+
+float t_randf(struct t_rand *r, int mode, float a, float b)
+{
+	return sample(r, &ff, mode, a, b);
+}
+
+double t_randd(struct t_rand *r, int mode, double a, double b)
+{
+	return sample(r, &fd, mode, a, b);
+}
+
+long double t_randl(struct t_rand *r, int mode, long double a, long double b)
+{
+	return sample(r, &fl, mode, a, b);
+}
@@ -1,4 +1,7 @@
+#define _GNU_SOURCE
 #include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
 #include <string.h>
 #include <errno.h>
 #include <signal.h>
@@ -7,20 +10,68 @@
 #include <sys/wait.h>
 #include <sys/time.h>
 #include <sys/resource.h>
+#include <sys/ptrace.h>
 #include <unistd.h>
 #include "test.h"
 
+/* PTRACE_GET_SYSCALL_INFO (linux 5.3), the libc may not have it */
+#ifndef PTRACE_GET_SYSCALL_INFO
+#define PTRACE_GET_SYSCALL_INFO 0x420e
+#endif
+struct scinfo {
+	uint8_t op;
+	uint8_t pad[3];
+	uint32_t arch;
+	uint64_t ip;
+	uint64_t sp;
+	union {
+		struct {
+			uint64_t nr;
+			uint64_t args[6];
+		} entry;
+		struct {
+			int64_t rval;
+			uint8_t is_error;
+		} exit;
+		struct {
+			uint64_t nr;
+			uint64_t args[6];
+			uint32_t ret_data;
+		} seccomp;
+	} u;
+};
+enum {SC_ENTRY = 1, SC_EXIT = 2};
+
+/* the syscall each traced thread is in */
+static struct call {
+	int pid;
+	int seen;
+	int64_t nr;
+	uint64_t a[3];
+} call[256];
+
 static void handler(int s)
 {
 }
 
-static int start(char *wrap, char *argv[])
+static int start(char *wrap, char *argv[], int traced, int timeoutsec)
 {
+	struct timespec ts;
+	char buf[32];
 	int pid;
 
 	pid = fork();
 	if (pid == 0) {
 		t_setrlim(RLIMIT_STACK, 100*1024);
+		/* when the test is killed, so benchmarks can finish in time (see bench.c) */
+		clock_gettime(CLOCK_MONOTONIC, &ts);
+		snprintf(buf, sizeof buf, "%lld", (long long)ts.tv_sec + timeoutsec);
+		setenv("T_DEADLINE", buf, 1);
+		if (traced) {
+			/* stop until the tracer has set its options */
+			ptrace(PTRACE_TRACEME, 0, 0, 0);
+			raise(SIGSTOP);
+		}
 		if (*wrap) {
 			argv--;
 			argv[0] = wrap;
@@ -32,15 +83,136 @@ static int start(char *wrap, char *argv[])
 	return pid;
 }
 
+static struct call *getcall(int pid)
+{
+	struct call *c, *e = 0;
+
+	for (c = call; c < call + sizeof call / sizeof *call; c++)
+		if (c->pid == pid)
+			return c;
+		else if (!c->pid && !e)
+			e = c;
+	if (e) {
+		e->pid = pid;
+		e->seen = 0;
+		e->nr = -1;
+	}
+	return e;
+}
+
+static void record(FILE *f, int pid, struct call *c)
+{
+	struct scinfo si;
+
+	if (!c || ptrace(PTRACE_GET_SYSCALL_INFO, pid, (void *)sizeof si, &si) <= 0)
+		return;
+	if (si.op == SC_ENTRY) {
+		c->nr = si.u.entry.nr;
+		memcpy(c->a, si.u.entry.args, sizeof c->a);
+	} else if (si.op == SC_EXIT && c->nr >= 0) {
+		fprintf(f, "%d %lld(%#llx, %#llx, %#llx) = %lld\n", pid, (long long)c->nr,
+			(unsigned long long)c->a[0], (unsigned long long)c->a[1],
+			(unsigned long long)c->a[2], (long long)si.u.exit.rval);
+		c->nr = -1;
+	}
+}
+
+/* the thread left in a syscall that did not return (exit, exec) */
+static void gone(FILE *f, struct call *c)
+{
+	if (!c)
+		return;
+	if (c->nr >= 0)
+		fprintf(f, "%d %lld(%#llx, %#llx, %#llx) = ?\n", c->pid, (long long)c->nr,
+			(unsigned long long)c->a[0], (unsigned long long)c->a[1],
+			(unsigned long long)c->a[2]);
+	c->pid = 0;
+}
+
+/*
+run the test under ptrace writing one line per syscall of each of its
+threads and children to f as
+
+pid nr(arg0, arg1, arg2) = ret
+
+the syscall numbers are the ones of the traced architecture. returns 1
+if the timeout killed the test, 0 if it exited, -1 on failure.
+*/
+static int trace(int pid, int timeoutsec, FILE *f, sigset_t *set, int *status)
+{
+	struct timespec end, now, left;
+	struct call *c;
+	int w, s, sig, timeout = 0;
+
+	if (waitpid(pid, &s, 0) != pid || !WIFSTOPPED(s))
+		return -1;
+	if (ptrace(PTRACE_SETOPTIONS, pid, 0, PTRACE_O_TRACESYSGOOD|PTRACE_O_EXITKILL|
+			PTRACE_O_TRACECLONE|PTRACE_O_TRACEFORK|PTRACE_O_TRACEVFORK|
+			PTRACE_O_TRACEEXEC) == -1)
+		return -1;
+	getcall(pid)->seen = 1;
+	ptrace(PTRACE_SYSCALL, pid, 0, 0);
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	end.tv_sec += timeoutsec;
+	for (;;) {
+		while ((w = waitpid(-1, &s, __WALL|WNOHANG)) > 0) {
+			c = getcall(w);
+			if (WIFEXITED(s) || WIFSIGNALED(s)) {
+				gone(f, c);
+				if (w == pid) {
+					*status = s;
+					return timeout;
+				}
+				continue;
+			}
+			if (!WIFSTOPPED(s))
+				continue;
+			sig = WSTOPSIG(s);
+			if (sig == (SIGTRAP|0x80)) {
+				record(f, w, c);
+				sig = 0;
+			} else if (sig == SIGTRAP && s>>16) {
+				/* clone, fork or exec event */
+				sig = 0;
+			} else if (sig == SIGSTOP && (!c || !c->seen)) {
+				/* the first stop of a new thread or child */
+				sig = 0;
+			}
+			if (c)
+				c->seen = 1;
+			ptrace(PTRACE_SYSCALL, w, 0, (void *)(long)sig);
+		}
+		if (w == -1 && errno != EINTR)
+			return -1;
+		clock_gettime(CLOCK_MONOTONIC, &now);
+		left.tv_sec = end.tv_sec - now.tv_sec;
+		left.tv_nsec = end.tv_nsec - now.tv_nsec;
+		if (left.tv_nsec < 0) {
+			left.tv_sec--;
+			left.tv_nsec += 1000000000;
+		}
+		if (!timeout && left.tv_sec < 0) {
+			timeout = 1;
+			if (kill(pid, SIGKILL) == -1)
+				return -1;
+		}
+		if (timeout)
+			left = (struct timespec){1,0};
+		sigtimedwait(set, 0, &left);
+	}
+}
+
 static void usage(char *argv[])
 {
-	t_error("usage: %s [-t timeoutsec] [-w wrapcmd] cmd [args..]\n", argv[0]);
+	t_error("usage: %s [-t timeoutsec] [-w wrapcmd] [-s tracefile] cmd [args..]\n", argv[0]);
 	exit(-1);
 }
 
 int main(int argc, char *argv[])
 {
 	char *wrap = "";
+	char *tracefile = 0;
+	FILE *f;
 	int timeoutsec = 5;
 	int timeout = 0;
 	int status;
@@ -48,11 +220,14 @@ int main(int argc, char *argv[])
 	int opt;
 	int pid;
 
-	while ((opt = getopt(argc, argv, "w:t:")) != -1) {
+	while ((opt = getopt(argc, argv, "w:t:s:")) != -1) {
 		switch (opt) {
 		case 'w':
 			wrap = optarg;
 			break;
+		case 's':
+			tracefile = optarg;
+			break;
 		case 't':
 			timeoutsec = atoi(optarg);
 			break;
@@ -67,13 +242,25 @@ int main(int argc, char *argv[])
 	sigaddset(&set, SIGCHLD);
 	sigprocmask(SIG_BLOCK, &set, 0);
 	signal(SIGCHLD, handler);
-	pid = start(wrap, argv);
+	pid = start(wrap, argv, !!tracefile, timeoutsec);
 	if (pid == -1) {
 		t_error("%s fork failed: %s\n", argv[0], strerror(errno));
 		t_printf("FAIL %s [internal]\n", argv[0]);
 		return -1;
 	}
-	if (sigtimedwait(&set, 0, &(struct timespec){timeoutsec,0}) == -1) {
+	if (tracefile) {
+		if (!(f = fopen(tracefile, "w")))
+			t_error("%s: %s\n", tracefile, strerror(errno));
+		else if ((timeout = trace(pid, timeoutsec, f, &set, &status)) < 0)
+			t_error("%s tracing failed: %s\n", argv[0], strerror(errno));
+		if (f)
+			fclose(f);
+		if (!f || timeout < 0) {
+			kill(pid, SIGKILL);
+			t_printf("FAIL %s [internal]\n", argv[0]);
+			return -1;
+		}
+	} else if (sigtimedwait(&set, 0, &(struct timespec){timeoutsec,0}) == -1) {
 		if (errno == EAGAIN)
 			timeout = 1;
 		else
@@ -81,7 +268,8 @@ int main(int argc, char *argv[])
 		if (kill(pid, SIGKILL) == -1)
 			t_error("%s kill failed: %s\n", argv[0], strerror(errno));
 	}
-	if (waitpid(pid, &status, 0) != pid) {
+	/* the tracer has already waited */
+	if (!tracefile && waitpid(pid, &status, 0) != pid) {
 		t_error("%s waitpid failed: %s\n", argv[0], strerror(errno));
 		t_printf("FAIL %s [internal]\n", argv[0]);
 		return -1;
@@ -0,0 +1,417 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <errno.h>
+#include <sched.h>
+#include <signal.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/prctl.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <linux/filter.h>
+#include <linux/seccomp.h>
+#include "test.h"
+
+/*
+syscall fault injection and counting with seccomp.
+
+a call that fails from now on on every invocation is a plain filter that
+returns the errno, it cannot be removed and is inherited by children.
+
+counted failures (the nth call, only once) need state: a filter sends
+every syscall of the calling thread (and of the threads it creates
+later) to a supervisor thread that is started before the filter, so its
+own calls are not filtered. it matches the calls against a small rule
+table, every matching rule counts the call and it fails if any of them
+fails it, otherwise it runs. a failed brk returns
+the old break as the kernel does, other calls return -err. a process can
+only have one such listener, so all counted rules share it. forked
+children are served by the supervisor of their parent, they must not
+outlive it, and exec leaves no supervisor, so a process with counted
+rules should not exec.
+
+allocation failures are a counted rule on anonymous mmap, mremap and brk,
+a rule without errno only counts the calls (t_syscount). allocations
+served from the existing heap make no syscall, T_AFMALLOC fails the
+malloc calls instead, that needs the replacement malloc of alloccount.o
+linked into the test.
+*/
+
+/* in alloccount.o if it is linked */
+int t_mallocfail(long n, int once, volatile long *shared);
+#pragma weak t_mallocfail
+
+/* rule nr besides syscall numbers */
+enum {ANY = -1, ALLOC = -2};
+
+struct rule {
+	long nr;
+	long n;
+	long count;
+	int err;     /* 0: only count */
+	int once;
+	int kinds;   /* T_AFMMAP|T_AFBRK for ALLOC */
+	int sweep;   /* counts are reported to the sweeping parent */
+	int used;
+};
+
+static struct {
+	volatile int fd;   /* -1: not installed, -2: install failed */
+	volatile int ready;
+	volatile int lock;
+	struct rule r[8];
+} sf = {-1};
+
+/*
+a spin lock: a filtered thread waiting on a mutex could make a futex call
+the supervisor has to serve while it waits for the same lock. only the
+supervisor yields, the syscalls of a filtered thread would be counted.
+*/
+static void acquire(int yield)
+{
+	while (__sync_lock_test_and_set(&sf.lock, 1))
+		if (yield)
+			sched_yield();
+}
+
+static void release(void)
+{
+	__sync_lock_release(&sf.lock);
+}
+
+/* shared with the parent of a sweep */
+static volatile struct {
+	long count;
+	long nr;
+} *sweepinfo;
+
+static int allockind(const struct seccomp_data *d)
+{
+	switch (d->nr) {
+	case SYS_brk:
+		return T_AFBRK;
+	case SYS_mremap:
+		return T_AFMMAP;
+	case SYS_mmap:
+#ifdef SYS_mmap2
+	case SYS_mmap2:
+#endif
+		return d->args[3] & MAP_ANONYMOUS ? T_AFMMAP : 0;
+	}
+	return 0;
+}
+
+static int match(const struct rule *r, const struct seccomp_data *d)
+{
+	if (r->nr == d->nr)
+		return 1;
+	if (r->nr == ALLOC)
+		return (allockind(d) & r->kinds) != 0;
+	/* keep the output of the test */
+	if (r->nr == ANY)
+		return !(d->nr == SYS_write && d->args[0] - 1 < 2);
+	return 0;
+}
+
+/* count the call in every matching rule, the errno if any of them fails it */
+static int check(const struct seccomp_data *d)
+{
+	struct rule *r;
+	int err = 0, e;
+
+	for (r = sf.r; r < sf.r + sizeof sf.r / sizeof *sf.r; r++) {
+		if (!r->used || !match(r, d))
+			continue;
+		e = r->err && (r->once ? r->count == r->n : r->count >= r->n) ? r->err : 0;
+		if (e && !err)
+			err = e;
+		r->count++;
+		if (r->sweep && sweepinfo) {
+			sweepinfo->count = r->count;
+			if (e)
+				sweepinfo->nr = d->nr;
+		}
+	}
+	return err;
+}
+
+static void *supervise(void *arg)
+{
+	struct seccomp_notif_sizes sz;
+	struct seccomp_notif *req;
+	struct seccomp_notif_resp *resp;
+	int fd, err;
+
+	/* malloc before the filter, the filtered thread may hold its lock */
+	if (syscall(SYS_seccomp, SECCOMP_GET_NOTIF_SIZES, 0, &sz) < 0)
+		sz.seccomp_notif = sz.seccomp_notif_resp = 0;
+	req = malloc(sz.seccomp_notif > sizeof *req ? sz.seccomp_notif : sizeof *req);
+	resp = malloc(sz.seccomp_notif_resp > sizeof *resp ? sz.seccomp_notif_resp : sizeof *resp);
+	sf.ready = 1;
+	/* a futex would be filtered before the supervisor runs */
+	while ((fd = sf.fd) == -1)
+		sched_yield();
+	if (fd < 0 || !req || !resp || !sz.seccomp_notif)
+		return 0;
+	for (;;) {
+		memset(req, 0, sz.seccomp_notif);
+		if (ioctl(fd, SECCOMP_IOCTL_NOTIF_RECV, req) < 0) {
+			if (errno == EINTR || errno == ENOENT)
+				continue;
+			return 0;
+		}
+		memset(resp, 0, sz.seccomp_notif_resp);
+		resp->id = req->id;
+		acquire(1);
+		err = check(&req->data);
+		release();
+		if (!err)
+			resp->flags = SECCOMP_USER_NOTIF_FLAG_CONTINUE;
+		else if (req->data.nr == SYS_brk)
+			resp->val = syscall(SYS_brk, 0);
+		else
+			resp->error = -err;
+		ioctl(fd, SECCOMP_IOCTL_NOTIF_SEND, resp);
+	}
+}
+
+static int filter(struct sock_filter *insn, int n, unsigned flags)
+{
+	struct sock_fprog prog = {n, insn};
+
+	if (prctl(PR_SET_NO_NEW_PRIVS, 1, 0, 0, 0) < 0)
+		return -1;
+	return syscall(SYS_seccomp, SECCOMP_SET_MODE_FILTER, flags, &prog);
+}
+
+static int install(void)
+{
+	struct sock_filter insn[] = {
+		BPF_STMT(BPF_LD|BPF_W|BPF_ABS, offsetof(struct seccomp_data, nr)),
+		BPF_JUMP(BPF_JMP|BPF_JEQ|BPF_K, SYS_rt_sigreturn, 4, 0),
+#ifdef SYS_sigreturn
+		BPF_JUMP(BPF_JMP|BPF_JEQ|BPF_K, SYS_sigreturn, 3, 0),
+#else
+		BPF_JUMP(BPF_JMP|BPF_JEQ|BPF_K, SYS_rt_sigreturn, 3, 0),
+#endif
+		BPF_JUMP(BPF_JMP|BPF_JEQ|BPF_K, SYS_exit, 2, 0),
+		BPF_JUMP(BPF_JMP|BPF_JEQ|BPF_K, SYS_exit_group, 1, 0),
+		BPF_STMT(BPF_RET|BPF_K, SECCOMP_RET_USER_NOTIF),
+		BPF_STMT(BPF_RET|BPF_K, SECCOMP_RET_ALLOW),
+	};
+	pthread_t td;
+	int fd;
+
+	if ((errno = pthread_create(&td, 0, supervise, 0)))
+		return -1;
+	pthread_detach(td);
+	while (!sf.ready)
+		sched_yield();
+	fd = filter(insn, sizeof insn / sizeof *insn, SECCOMP_FILTER_FLAG_NEW_LISTENER);
+	sf.fd = fd < 0 ? -2 : fd;
+	return fd < 0 ? -1 : 0;
+}
+
+/* replace the rule with the same nr, an unused one removes it */
+static int setrule(struct rule n)
+{
+	struct rule *r, *p = 0;
+
+	acquire(0);
+	for (r = sf.r; r < sf.r + sizeof sf.r / sizeof *sf.r; r++)
+		if (r->used && r->nr == n.nr) {
+			p = r;
+			break;
+		} else if (!r->used && !p) {
+			p = r;
+		}
+	if (p)
+		*p = n;
+	release();
+	if (!p) {
+		errno = ENOSPC;
+		return -1;
+	}
+	if (n.used && sf.fd == -1 && install() < 0) {
+		p->used = 0;
+		return -1;
+	}
+	return sf.fd == -2 && n.used ? -1 : 0;
+}
+
+/*
+from now on the first n calls of syscall nr (-1: every syscall but
+writes to stdout and stderr) succeed and the following ones fail with
+err (only the next one with T_SFONCE), calling it again resets the
+count, err 0 removes the rule. n 0 without T_SFONCE is the permanent
+filter (see above). returns -1 if not supported.
+*/
+int t_sysfail(long nr, long n, int err, int flags)
+{
+	struct sock_filter insn[] = {
+		BPF_STMT(BPF_LD|BPF_W|BPF_ABS, offsetof(struct seccomp_data, nr)),
+		BPF_JUMP(BPF_JMP|BPF_JEQ|BPF_K, nr, 0, 1),
+		BPF_STMT(BPF_RET|BPF_K, SECCOMP_RET_ERRNO | (err & SECCOMP_RET_DATA)),
+		BPF_STMT(BPF_RET|BPF_K, SECCOMP_RET_ALLOW),
+	};
+	struct rule r = {nr, n, 0, err, flags & T_SFONCE, 0, 0, err != 0};
+
+	if (nr < ANY) {
+		errno = EINVAL;
+		return -1;
+	}
+	if (n == 0 && !r.once && err) {
+		if (nr == ANY) {
+			errno = EINVAL;
+			return -1;
+		}
+		return filter(insn, sizeof insn / sizeof *insn, 0) < 0 ? -1 : 0;
+	}
+	return setrule(r);
+}
+
+/*
+from now on the first n allocation calls of the kinds in flags succeed
+and the following ones fail (only the next one with T_AFONCE), calling
+it again resets the count, returns -1 if not supported. T_AFMALLOC
+cannot be combined with the syscall kinds.
+*/
+int t_allocfail(long n, int flags)
+{
+	struct rule r = {ALLOC, n, 0, ENOMEM, !!(flags & T_AFONCE), flags & T_AFALL, 0, !!(flags & T_AFALL)};
+
+	if (flags & T_AFMALLOC) {
+		if (flags & T_AFALL) {
+			errno = EINVAL;
+			return -1;
+		}
+		if (!t_mallocfail) {
+			errno = ENOSYS;
+			return -1;
+		}
+		return t_mallocfail(n, r.once, 0);
+	}
+	return setrule(r);
+}
+
+/*
+count the calls of syscall nr (-1: every syscall but writes to stdout
+and stderr) from now on, replacing a failure rule of nr. returns -1 if
+not supported.
+*/
+int t_syscount(long nr)
+{
+	struct rule r = {nr, 0, 0, 0, 0, 0, 0, 1};
+
+	if (nr < ANY) {
+		errno = EINVAL;
+		return -1;
+	}
+	return setrule(r);
+}
+
+/* calls of nr since t_syscount(nr), -1 if they are not counted */
+long t_syscalls(long nr)
+{
+	struct rule *r;
+	long n = -1;
+
+	acquire(0);
+	for (r = sf.r; r < sf.r + sizeof sf.r / sizeof *sf.r; r++)
+		if (r->used && r->nr == nr)
+			n = r->count;
+	release();
+	return n;
+}
+
+static long sweep(int (*f)(void *), void *arg, struct rule r, const char *what)
+{
+	char nr[32];
+	pid_t pid;
+	int ret, status;
+
+	if ((r.kinds & T_AFMALLOC) && !t_mallocfail) {
+		errno = ENOSYS;
+		return -1;
+	}
+	if (!sweepinfo) {
+		void *p = mmap(0, sizeof *sweepinfo, PROT_READ|PROT_WRITE, MAP_SHARED|MAP_ANONYMOUS, -1, 0);
+		if (p == MAP_FAILED)
+			return -1;
+		sweepinfo = p;
+	}
+	r.sweep = 1;
+	for (r.n = 0; ; r.n++) {
+		sweepinfo->count = 0;
+		sweepinfo->nr = -1;
+		/* the child exits normally, it must not write the parent's buffers again */
+		fflush(0);
+		pid = fork();
+		if (pid < 0)
+			return -1;
+		if (pid == 0) {
+			if (r.kinds & T_AFMALLOC)
+				t_mallocfail(r.n, r.once, &sweepinfo->count);
+			else if (setrule(r) < 0) {
+				t_error("installing the %s failure failed: %s\n", what, strerror(errno));
+				_exit(1);
+			}
+			ret = f(arg);
+			/* the exit path is not part of f */
+			if (r.kinds & T_AFMALLOC)
+				t_mallocfail(-1, 0, 0);
+			r.used = 0;
+			setrule(r);
+			exit(ret);
+		}
+		if (waitpid(pid, &status, 0) != pid)
+			return -1;
+		snprintf(nr, sizeof nr, sweepinfo->nr < 0 ? "" : " (syscall %ld)", sweepinfo->nr);
+		if (WIFSIGNALED(status))
+			t_error("failing %s %ld%s: killed by signal %d (%s)\n",
+				what, r.n, nr, WTERMSIG(status), strsignal(WTERMSIG(status)));
+		else if ((ret = WEXITSTATUS(status)))
+			t_error("failing %s %ld%s: exit status %d\n",
+				what, r.n, nr, ret);
+		if (sweepinfo->count == 0)
+			t_error("no %s of f was reached by the sweep\n", what);
+		if (sweepinfo->count <= r.n)
+			return r.n + 1;
+	}
+}
+
+/*
+calls f(arg) in a child process for n = 0, 1, .. with t_allocfail(n,
+flags) until f makes no more than n allocation calls, so every
+allocation point of f fails once (or every tail with persistent
+failures). a crash or nonzero return of f is reported, and so is an f
+that makes no allocation call at all. returns the number of runs or -1.
+must be called before t_allocfail.
+*/
+long t_allocsweep(int (*f)(void *), void *arg, int flags)
+{
+	struct rule r = {ALLOC, 0, 0, ENOMEM, !!(flags & T_AFONCE), flags & (T_AFALL|T_AFMALLOC), 0, 1};
+
+	if ((flags & T_AFMALLOC) && (flags & T_AFALL)) {
+		errno = EINVAL;
+		return -1;
+	}
+	return sweep(f, arg, r, "allocation");
+}
+
+/*
+the same for every syscall of f (but writes to stdout and stderr): the
+nth one fails once with err in the nth child, f can check that the
+error is reported as err.
+*/
+long t_syssweep(int (*f)(void *), void *arg, int err)
+{
+	struct rule r = {ANY, 0, 0, err, 1, 0, 0, 1};
+
+	return sweep(f, arg, r, "syscall");
+}
@@ -1,20 +1,70 @@
 #include <stdint.h>
 #include <unistd.h>
 
-/* TODO: not thread-safe nor fork-safe */
-extern volatile int t_status;
+/* set by t_printf, shared by all threads and forked children (see print.c) */
+extern volatile int *t_statusp;
+#define t_status (*t_statusp)
 
 #define T_LOC2(l) __FILE__ ":" #l
 #define T_LOC1(l) T_LOC2(l)
 #define t_error(...) t_printf(T_LOC1(__LINE__) ": " __VA_ARGS__)
 
 int t_printf(const char *s, ...);
+/* format of the last t_printf, with t_error it starts with the file:line */
+extern const char *t_lastfmt;
 
 int t_vmfill(void **, size_t *, int);
 int t_memfill(void);
 
+/* syscall and allocation fault injection, see sysfail.c */
+enum {T_SFONCE = 1};
+int t_sysfail(long nr, long n, int err, int flags);
+long t_syssweep(int (*f)(void *), void *arg, int err);
+int t_syscount(long nr);
+long t_syscalls(long nr);
+enum {T_AFMMAP = 1, T_AFBRK = 2, T_AFONCE = 4, T_AFMALLOC = 8};
+#define T_AFALL (T_AFMMAP|T_AFBRK)
+int t_allocfail(long n, int flags);
+long t_allocsweep(int (*f)(void *), void *arg, int flags);
+
+/* allocation counting, see alloccount.c */
+struct t_alloc {
+	long malloc, calloc, realloc, free;
+	size_t bytes;
+};
+void t_alloccount(void);
+void t_allocs(struct t_alloc *);
+
 void t_fdfill(void);
 
+/* micro-benchmark results in seconds per iteration, see bench.c */
+struct t_bench {
+	double med, mad, p90, p99, min, max;
+	long iter;     /* iterations per sample */
+	int n;         /* samples kept */
+	int outliers;
+	/* hardware counters per iteration, -1 if not available */
+	double cycles, insn, cachemiss, branchmiss, tlbmiss;
+};
+int t_bench(struct t_bench *b, const char *name, void (*f)(void *, long), void *arg);
+int t_benchlat(struct t_bench *b, const char *name, void (*setup)(void *), void (*f)(void *), void *arg);
+void t_benchprint(const char *name, const struct t_bench *b);
+
+/* in process fuzzing of a target, see fuzz.c */
+struct t_fuzz {
+	const char *file;          /* target source, __FILE__ */
+	unsigned long (*run)(const unsigned char *p, size_t n);
+	const char *const *dict;   /* tokens for the mutations, 0 terminated */
+	const char *const *seed;   /* initial inputs, 0 terminated */
+	size_t max;                /* input size limit */
+};
+int t_fuzz(const struct t_fuzz *z, int argc, char *argv[]);
+
+/* prng state, each thread can use its own (see t_randstream) */
+struct t_rand {
+	uint64_t s[4];
+};
+
 void t_randseed(uint64_t s);
 uint64_t t_randn(uint64_t n);
 uint64_t t_randint(uint64_t a, uint64_t b);
@@ -22,6 +72,22 @@ void t_shuffle(uint64_t *p, size_t n);
 void t_randrange(uint64_t *p, size_t n);
 int t_choose(uint64_t n, size_t k, uint64_t *p);
 
+void t_randseed_r(struct t_rand *r, uint64_t s);
+void t_randjump_r(struct t_rand *r);
+void t_randstream(struct t_rand *r, uint64_t seed, uint64_t i);
+uint64_t t_rand64_r(struct t_rand *r);
+uint64_t t_randn_r(struct t_rand *r, uint64_t n);
+uint64_t t_randint_r(struct t_rand *r, uint64_t a, uint64_t b);
+void t_shuffle_r(struct t_rand *r, uint64_t *p, size_t n);
+void t_randrange_r(struct t_rand *r, uint64_t *p, size_t n);
+int t_choose_r(struct t_rand *r, uint64_t n, size_t k, uint64_t *p);
+
+/* floating-point sampling modes on [a,b], see randfp.c */
+enum {T_FULP, T_FEXP, T_FNEAR, T_FSUB};
+float t_randf(struct t_rand *r, int mode, float a, float b);
+double t_randd(struct t_rand *r, int mode, double a, double b);
+long double t_randl(struct t_rand *r, int mode, long double a, long double b);
+
 char *t_pathrel(char *buf, size_t n, char *argv0, char *p);
 
 int t_setrlim(int r, long lim);
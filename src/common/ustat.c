@@ -0,0 +1,99 @@
+#include <stdio.h>
+#include <math.h>
+#include "mtest.h"
+
+/* exponent ranges: 0, below xedge[0], between the edges, above the last edge, inf and nan */
+static const int xedge[USTAT_NX-3] = {
+	-1022, -126, -64, -16, -8, -4, -2, -1, 0, 1, 2, 4, 8, 16, 64, 128, 1024};
+static const float eedge[USTAT_NE-1] = {0.5, 1, 1.5, 2, 4, 16, 256};
+static const char *ename[USTAT_NE] = {
+	"<=0.5", "<=1", "<=1.5", "<=2", "<=4", "<=16", "<=256", ">256"};
+
+static int ridx(int r)
+{
+	return r == RN ? 0 : r == RZ ? 1 : r == RD ? 2 : 3;
+}
+
+static int rval(int i)
+{
+	static const int r[] = {RN, RZ, RD, RU};
+	return r[i];
+}
+
+void ustat_add(struct ustat *s, int r, long double x, float ulperr)
+{
+	int i, j, e;
+
+	if (!s)
+		return;
+	if (x == 0)
+		i = 0;
+	else if (!isfinite(x))
+		i = USTAT_NX-1;
+	else {
+		e = ilogbl(x);
+		for (i = 0; i < USTAT_NX-3 && e >= xedge[i]; i++);
+		i++;
+	}
+	ulperr = fabsf(ulperr);
+	if (isnan(ulperr))
+		ulperr = INFINITY;
+	for (j = 0; j < USTAT_NE-1 && ulperr > eedge[j]; j++);
+	r = ridx(r);
+	s->n[r][i][j]++;
+	if (ulperr > s->max[r][i])
+		s->max[r][i] = ulperr;
+}
+
+void ustat_xname(char *buf, size_t n, int i)
+{
+	if (i == 0)
+		snprintf(buf, n, "0");
+	else if (i == USTAT_NX-1)
+		snprintf(buf, n, "inf/nan");
+	else if (i == 1)
+		snprintf(buf, n, "<2^%d", xedge[0]);
+	else if (i == USTAT_NX-2)
+		snprintf(buf, n, ">=2^%d", xedge[USTAT_NX-4]);
+	else
+		snprintf(buf, n, "2^%d..2^%d", xedge[i-2], xedge[i-1]);
+}
+
+int ustat_xbound(int i, int *lo, int *hi)
+{
+	if (i < 2 || i > USTAT_NX-3)
+		return 0;
+	*lo = xedge[i-2];
+	*hi = xedge[i-1];
+	return 1;
+}
+
+void ustat_csvhead(FILE *f)
+{
+	int j;
+
+	fprintf(f, "func,mode,|x|,n");
+	for (j = 0; j < USTAT_NE; j++)
+		fprintf(f, ",%s", ename[j]);
+	fprintf(f, ",max\n");
+}
+
+void ustat_csv(FILE *f, const char *name, const struct ustat *s)
+{
+	char buf[32];
+	unsigned long n;
+	int r, i, j;
+
+	for (r = 0; r < 4; r++)
+		for (i = 0; i < USTAT_NX; i++) {
+			for (n = j = 0; j < USTAT_NE; j++)
+				n += s->n[r][i][j];
+			if (!n)
+				continue;
+			ustat_xname(buf, sizeof buf, i);
+			fprintf(f, "%s,%s,%s,%lu", name, rstr(rval(r)), buf, n);
+			for (j = 0; j < USTAT_NE; j++)
+				fprintf(f, ",%lu", s->n[r][i][j]);
+			fprintf(f, ",%.3f\n", s->max[r][i]);
+		}
+}
@@ -0,0 +1,21 @@
+#include <stdio.h>
+
+/*
+ulp error statistics of a function: the error is binned by its size and
+the binary exponent range of the first input, per rounding mode, so
+accuracy differences can be located in the input domain.
+*/
+enum {USTAT_NX = 20, USTAT_NE = 8};
+struct ustat {
+	unsigned long n[4][USTAT_NX][USTAT_NE];
+	float max[4][USTAT_NX];
+};
+
+/* s may be 0 */
+void ustat_add(struct ustat *s, int r, long double x, float ulperr);
+/* one csv line per non-empty rounding mode and input range */
+void ustat_csv(FILE *, const char *name, const struct ustat *);
+void ustat_csvhead(FILE *);
+/* name of input range i, its binary exponent bounds [lo,hi) if it is bounded */
+void ustat_xname(char *buf, size_t n, int i);
+int ustat_xbound(int i, int *lo, int *hi);
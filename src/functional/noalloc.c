@@ -0,0 +1,73 @@
+// formatting and conversion calls should not allocate
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <iconv.h>
+#include "test.h"
+
+static void check(const char *what)
+{
+	struct t_alloc c;
+
+	t_allocs(&c);
+	if (c.malloc || c.calloc || c.realloc)
+		t_error("%s allocated: %ld malloc, %ld calloc, %ld realloc, %lu bytes\n",
+			what, c.malloc, c.calloc, c.realloc, (unsigned long)c.bytes);
+	t_alloccount();
+}
+
+static int cmp(const void *a, const void *b)
+{
+	return *(const int *)a - *(const int *)b;
+}
+
+int main(void)
+{
+	char buf[256], out[64];
+	char *in, *o;
+	size_t inlen, outlen;
+	int a[100];
+	iconv_t cd;
+	struct t_alloc c;
+	double d;
+	int i;
+
+	/* the counting itself works, otherwise the checks below pass vacuously */
+	t_alloccount();
+	free(malloc(1));
+	t_allocs(&c);
+	if (c.malloc != 1 || c.free != 1)
+		t_error("free(malloc(1)) counted %ld malloc and %ld free, want 1 and 1\n", c.malloc, c.free);
+
+	/* setup outside the counted regions */
+	for (i = 0; i < 100; i++)
+		a[i] = (i * 37) % 100;
+	cd = iconv_open("UTF-8", "ISO-8859-1");
+	if (cd == (iconv_t)-1)
+		t_error("iconv_open failed: %s\n", strerror(errno));
+
+	t_alloccount();
+	snprintf(buf, sizeof buf, "%d %s %x %c %p", 42, "str", 0xbeef, 'c', (void *)&i);
+	check("snprintf of integers and strings");
+	snprintf(buf, sizeof buf, "%g %.17e %.3f %a", 0.1, 1e300, -2.5, 0x1p-1074);
+	check("snprintf of floats");
+	d = strtod("0.1", 0);
+	d += strtod("1.7976931348623157e308", 0);
+	d += strtod("4.9406564584124654e-324", 0);
+	d += strtod("0x1.fffffffffffffp1023", 0);
+	check("strtod");
+	qsort(a, 100, sizeof *a, cmp);
+	check("qsort of 100 ints");
+	if (cd != (iconv_t)-1) {
+		in = "caf\xe9";
+		inlen = 4;
+		o = out;
+		outlen = sizeof out;
+		if (iconv(cd, &in, &inlen, &o, &outlen) == (size_t)-1)
+			t_error("iconv failed: %s\n", strerror(errno));
+		check("iconv from latin1 to utf-8");
+		iconv_close(cd);
+	}
+	return t_status;
+}
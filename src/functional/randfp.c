@@ -0,0 +1,158 @@
+// the floating-point samplers of the test library: range and binade shares
+#include <float.h>
+#include <math.h>
+#include "test.h"
+
+#define N 20000
+
+static long double rf(struct t_rand *r, int m, long double a, long double b)
+{
+	return t_randf(r, m, a, b);
+}
+
+static long double rd(struct t_rand *r, int m, long double a, long double b)
+{
+	return t_randd(r, m, a, b);
+}
+
+static long double rl(struct t_rand *r, int m, long double a, long double b)
+{
+	return t_randl(r, m, a, b);
+}
+
+static const struct {
+	const char *name;
+	long double (*f)(struct t_rand *, int, long double, long double);
+	int p;
+	long double min, max;
+} types[] = {
+	{"t_randf", rf, FLT_MANT_DIG, FLT_MIN, FLT_MAX},
+	{"t_randd", rd, DBL_MANT_DIG, DBL_MIN, DBL_MAX},
+	{"t_randl", rl, LDBL_MANT_DIG, LDBL_MIN, LDBL_MAX},
+};
+
+static const char *modes[] = {"T_FULP", "T_FEXP", "T_FNEAR", "T_FSUB"};
+
+static struct t_rand r;
+static long cnt[64];
+
+/* counts of the binades 2^lo .. 2^(lo+63) in [a,b], 1 if all samples are in range */
+static int hist(int t, int m, long double a, long double b, int lo)
+{
+	long double x;
+	int i, e;
+
+	for (i = 0; i < 64; i++)
+		cnt[i] = 0;
+	for (i = 0; i < N; i++) {
+		x = types[t].f(&r, m, a, b);
+		if (!(x >= a && x <= b)) {
+			t_error("%s(%s, %La, %La) = %La is out of range\n",
+				types[t].name, modes[m], a, b, x);
+			return 0;
+		}
+		e = x > 0 ? ilogbl(x) - lo : -1;
+		if (e >= 0 && e < 64)
+			cnt[e]++;
+	}
+	return 1;
+}
+
+/* share of the samples in binade e is within 0.03 of want */
+static void share(int t, int m, long double a, long double b, int lo, int e, double want)
+{
+	double got = (double)cnt[e - lo] / N;
+
+	if (fabs(got - want) > 0.03)
+		t_error("%s(%s, %La, %La) binade 2^%d share %.3f, want %.3f\n",
+			types[t].name, modes[m], a, b, e, got, want);
+}
+
+static void ranges(int t)
+{
+	long double min = types[t].min, max = types[t].max;
+	long double ab[][2] = {
+		{1, 2}, {-3, 0x1p33}, {0, 4*min}, {-1, -0.5}, {0.5, 0.5},
+		{0, 0}, {-8*min, min}, {-max, max}, {0.75, max},
+	};
+	int i, m;
+
+	for (m = 0; m < 4; m++)
+		for (i = 0; i < sizeof ab/sizeof *ab; i++)
+			hist(t, m, ab[i][0], ab[i][1], 0);
+}
+
+static void dist(int t)
+{
+	long double min = types[t].min, x, c;
+	long b[3] = {0};
+	int i, n, e, p = types[t].p;
+
+	/* ulp uniform: the same share for each full binade */
+	if (hist(t, T_FULP, 0.5, 4, -1))
+		for (e = -1; e < 2; e++)
+			share(t, T_FULP, 0.5, 4, -1, e, 1/3.0);
+
+	/* exponent uniform: a binade counts by its share in [a,b] */
+	if (hist(t, T_FEXP, 1, 2, 0)) {
+		share(t, T_FEXP, 1, 2, 0, 0, 1);
+		share(t, T_FEXP, 1, 2, 0, 1, 0);
+	}
+	if (hist(t, T_FEXP, 1, 3, 0)) {
+		share(t, T_FEXP, 1, 3, 0, 0, 2/3.0);
+		share(t, T_FEXP, 1, 3, 0, 1, 1/3.0);
+	}
+	if (hist(t, T_FEXP, 1, 16, 0))
+		for (e = 0; e < 4; e++)
+			share(t, T_FEXP, 1, 16, 0, e, 0.25);
+	for (i = n = 0; i < N; i++)
+		n += types[t].f(&r, T_FEXP, -1, 1) < 0;
+	if (fabs((double)n/N - 0.5) > 0.03)
+		t_error("%s(T_FEXP, -1, 1) negative share %.3f, want 0.5\n", types[t].name, (double)n/N);
+
+	/* near integers and halfway points, exponent stratified (rounding moves
+	samples across the low binade boundaries, so those are not checked) */
+	if (hist(t, T_FNEAR, 1, 1000, 0))
+		for (e = 2; e < 9; e++)
+			share(t, T_FNEAR, 1, 1000, 0, e, 1/9.953);
+	for (i = 0; i < N; i++) {
+		/* at most 4 ulps of the integer or halfway point */
+		x = types[t].f(&r, T_FNEAR, 1, 1000);
+		c = roundl(2*x)/2;
+		if (fabsl(x - c) > ldexpl(4, ilogbl(c) - p + 1)) {
+			t_error("%s(T_FNEAR, 1, 1000) = %La is not near n/2\n", types[t].name, x);
+			break;
+		}
+	}
+
+	/* subnormals and the smallest normals, the boundaries often */
+	for (i = n = 0; i < N; i++) {
+		x = types[t].f(&r, T_FSUB, 0, 1);
+		if (x > 2*min) {
+			t_error("%s(T_FSUB, 0, 1) = %La is above 2*min\n", types[t].name, x);
+			break;
+		}
+		n += x < min;
+		b[0] += x == ldexpl(min, 1 - p);
+		b[1] += x == min - ldexpl(min, 1 - p);
+		b[2] += x == min;
+	}
+	/* 3/4 ulp uniform on [0,2*min], 1/4 the three boundaries */
+	if (fabs((double)n/N - (0.75/2 + 0.25*2/3)) > 0.03)
+		t_error("%s(T_FSUB, 0, 1) subnormal share %.3f, want 0.542\n", types[t].name, (double)n/N);
+	for (i = 0; i < 3; i++)
+		if (fabs((double)b[i]/N - 0.25/3) > 0.02)
+			t_error("%s(T_FSUB, 0, 1) boundary %d share %.3f, want 0.083\n", types[t].name, i, (double)b[i]/N);
+}
+
+int main(void)
+{
+	int t;
+
+	t_randseed_r(&r, 1);
+	for (t = 0; t < 3; t++) {
+		ranges(t);
+		dist(t);
+	}
+	return t_status;
+}
@@ -0,0 +1,64 @@
+// the prng of the test library: seeding, jump ahead and streams against
+// the reference splitmix64 and xoshiro256** (the jumped state was computed
+// independently as the 2^128th power of the state transition over GF(2))
+#include <stdint.h>
+#include <string.h>
+#include "test.h"
+
+static const uint64_t seed1[4] = {
+	0x910a2dec89025cc1ULL, 0xbeeb8da1658eec67ULL,
+	0xf893a2eefb32555eULL, 0x71c18690ee42c90bULL};
+static const uint64_t out1[4] = {
+	0xb3f2af6d0fc710c5ULL, 0x853b559647364ceaULL,
+	0x92f89756082a4514ULL, 0x642e1c7bc266a3a7ULL};
+static const uint64_t jump1[4] = {
+	0x53d630076a137dedULL, 0xed07f666882edfc6ULL,
+	0x963ec9617b0bdbd3ULL, 0x84b96906e4b2569aULL};
+
+static void state(const char *what, const struct t_rand *r, const uint64_t *want)
+{
+	int i;
+
+	for (i = 0; i < 4; i++)
+		if (r->s[i] != want[i])
+			t_error("%s: s[%d] = %#llx, want %#llx\n",
+				what, i, (unsigned long long)r->s[i], (unsigned long long)want[i]);
+}
+
+int main(void)
+{
+	struct t_rand r, a, b;
+	uint64_t x, y;
+	int i;
+
+	t_randseed_r(&r, 1);
+	state("t_randseed_r(1)", &r, seed1);
+	for (i = 0; i < 4; i++)
+		if ((x = t_rand64_r(&r)) != out1[i])
+			t_error("t_rand64_r output %d after t_randseed_r(1) = %#llx, want %#llx\n",
+				i, (unsigned long long)x, (unsigned long long)out1[i]);
+
+	t_randseed_r(&r, 1);
+	t_randjump_r(&r);
+	state("t_randjump_r after t_randseed_r(1)", &r, jump1);
+
+	t_randstream(&a, 1, 0);
+	state("t_randstream(1, 0)", &a, seed1);
+	t_randstream(&a, 1, 1);
+	state("t_randstream(1, 1)", &a, jump1);
+
+	/* a stream is reproducible and differs from its neighbours */
+	t_randstream(&a, 12345, 3);
+	t_randstream(&b, 12345, 3);
+	for (i = 0; i < 1000; i++)
+		if ((x = t_rand64_r(&a)) != (y = t_rand64_r(&b))) {
+			t_error("t_randstream(12345, 3) twice: output %d is %#llx and %#llx\n",
+				i, (unsigned long long)x, (unsigned long long)y);
+			break;
+		}
+	t_randstream(&a, 12345, 2);
+	t_randstream(&b, 12345, 4);
+	if (!memcmp(a.s, b.s, sizeof a.s) || t_rand64_r(&a) == t_rand64_r(&b))
+		t_error("t_randstream(12345, 2) and (12345, 4) are not distinct streams\n");
+	return t_status;
+}
@@ -0,0 +1,57 @@
+// stdio buffering: number of syscalls made by buffered streams
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include "test.h"
+
+#define LINE "0123456789abcdef\n"
+
+static char buf[1<<16];
+static int counting;
+
+static void count(const char *what, long max)
+{
+	long n;
+
+	if (!counting)
+		return;
+	n = t_syscalls(-1);
+
+	if (n > max)
+		t_error("%s made %ld syscalls, want at most %ld\n", what, n, max);
+	t_syscount(-1);
+}
+
+int main(void)
+{
+	FILE *f;
+	int i, c;
+
+	if (!(f = tmpfile())) {
+		t_error("tmpfile failed: %s\n", strerror(errno));
+		return t_status;
+	}
+	if (setvbuf(f, buf, _IOFBF, sizeof buf))
+		t_error("setvbuf failed\n");
+	/* without seccomp user notification only the data is checked */
+	counting = t_syscount(-1) == 0;
+
+	for (i = 0; i < 3000; i++)
+		fputs(LINE, f);
+	count("fputs of 3000 lines into a 64k buffer", 0);
+	for (i = 3000; i < 10000; i++)
+		fputs(LINE, f);
+	if (fflush(f))
+		t_error("fflush failed: %s\n", strerror(errno));
+	count("fputs of 10000 lines into a 64k buffer and fflush", 3);
+
+	rewind(f);
+	for (i = 0; (c = getc(f)) != EOF; i++);
+	if (i != 10000 * strlen(LINE))
+		t_error("read back %d bytes, want %d\n", i, 10000 * (int)strlen(LINE));
+	/* the seek, three full reads and the end of file */
+	count("reading 10000 lines with a 64k buffer", 5);
+
+	fclose(f);
+	return t_status;
+}
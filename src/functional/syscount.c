@@ -0,0 +1,44 @@
+// t_syscount with several threads making counted calls and reading the counts
+#define _GNU_SOURCE
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/syscall.h>
+#include "test.h"
+
+#define NTHREAD 8
+#define N 50000
+
+static void *run(void *arg)
+{
+	long i;
+
+	for (i = 0; i < N; i++) {
+		syscall(SYS_getppid);
+		t_syscalls(-1);
+	}
+	return 0;
+}
+
+int main(void)
+{
+	pthread_t td[NTHREAD];
+	long n;
+	int i, r;
+
+	/* without seccomp user notification there is nothing to check */
+	if (t_syscount(SYS_getppid) < 0 || t_syscount(-1) < 0)
+		return t_status;
+	for (i = 0; i < NTHREAD; i++)
+		if ((r = pthread_create(td + i, 0, run, 0))) {
+			t_error("pthread_create failed: %s\n", strerror(r));
+			break;
+		}
+	while (i--)
+		pthread_join(td[i], 0);
+	if ((n = t_syscalls(SYS_getppid)) != (long)NTHREAD * N)
+		t_error("t_syscalls(SYS_getppid) = %ld, want %ld\n", n, (long)NTHREAD * N);
+	if ((n = t_syscalls(-1)) < (long)NTHREAD * N)
+		t_error("t_syscalls(-1) = %ld, want at least %ld\n", n, (long)NTHREAD * N);
+	return t_status;
+}
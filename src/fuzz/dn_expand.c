@@ -0,0 +1,61 @@
+// dn_expand: the input is a dns message after a byte holding the offset
+// of the name in it, the expanded name must be terminated and the return
+// value within the message, simple names must survive dn_comp
+#define _DEFAULT_SOURCE 1
+#define _BSD_SOURCE 1
+#include <string.h>
+#include <resolv.h>
+#include "test.h"
+
+static int simple(const char *s)
+{
+	for (; *s; s++)
+		if (!strchr("abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789-.", *s))
+			return 0;
+	return 1;
+}
+
+static unsigned long run(const unsigned char *p, size_t n)
+{
+	const unsigned char *msg = p + 1;
+	unsigned char c[512];
+	char name[256], name2[256];
+	int len, off, r, k;
+
+	if (n < 2)
+		return 0;
+	len = n - 1;
+	off = p[0] % (len + 1);
+	memset(name, 'x', sizeof name);
+	r = dn_expand(msg, msg + len, msg + off, name, sizeof name);
+	if (r < 0)
+		return off << 1;
+	if (r < 1 || r > len - off)
+		t_error("dn_expand at offset %d of a %d byte message returned %d\n", off, len, r);
+	if (!memchr(name, 0, sizeof name)) {
+		t_error("dn_expand at offset %d of a %d byte message: name is not terminated\n", off, len);
+		return 0;
+	}
+	if (simple(name) && (k = dn_comp(name, c, sizeof c, 0, 0)) > 0) {
+		memset(name2, 'x', sizeof name2);
+		if (dn_expand(c, c + k, c, name2, sizeof name2) != k || strcmp(name, name2))
+			t_error("dn_expand of dn_comp(\"%s\") gave \"%.255s\"\n", name, name2);
+	}
+	return (unsigned long)strlen(name) << 16 | r << 1 | 1;
+}
+
+#ifndef T_FUZZREPRO
+int main(int argc, char *argv[])
+{
+	/* labels, compression pointers and a terminating root label */
+	static const char *const dict[] = {
+		"\3www", "\7example", "\3com", "\300", "\300\1", "\301", "\77", "\100", "\200", "\1.", "\1\\", 0
+	};
+	static const char *const seed[] = {
+		"\1\3www\7example\3com", "\3\1a\1b\300\1", "\1\300\1", "\2\3abc\300\2\1x\300\1", 0
+	};
+	static const struct t_fuzz z = {__FILE__, run, dict, seed, 300};
+
+	return t_fuzz(&z, argc, argv);
+}
+#endif
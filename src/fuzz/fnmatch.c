@@ -0,0 +1,71 @@
+// fnmatch: the first byte selects the flags, a \1 byte separates the
+// pattern from the string, for ascii input a pattern without special
+// characters must match only itself and the pattern escaping every
+// character of the string must match it
+#include <string.h>
+#include <fnmatch.h>
+#include "test.h"
+
+static int ascii(const char *s)
+{
+	for (; *s; s++)
+		if (*s & 0x80)
+			return 0;
+	return 1;
+}
+
+static unsigned long run(const unsigned char *p, size_t n)
+{
+	static const int flag[] = {FNM_NOESCAPE, FNM_PATHNAME, FNM_PERIOD};
+	const char *s, *str;
+	char pat[256], esc[512];
+	size_t len, i;
+	int fl = 0, r, r2 = 0;
+
+	if (!n)
+		return 0;
+	for (i = 0; i < sizeof flag / sizeof *flag; i++)
+		if (p[0] >> i & 1)
+			fl |= flag[i];
+	s = (const char *)p + 1;
+	str = strchr(s, '\1');
+	len = str ? str - s : strlen(s);
+	str = str ? str + 1 : "";
+	if (len >= sizeof pat)
+		len = sizeof pat - 1;
+	memcpy(pat, s, len);
+	pat[len] = 0;
+
+	r = fnmatch(pat, str, fl);
+	if (ascii(pat) && ascii(str)) {
+		if (!strpbrk(pat, "*?[\\")) {
+			r2 = fnmatch(pat, str, 0);
+			if ((r2 == 0) != !strcmp(pat, str))
+				t_error("fnmatch(\"%s\", \"%s\", 0) = %d\n", pat, str, r2);
+		}
+		for (i = 0; str[i] && 2*i+2 < sizeof esc; i++) {
+			esc[2*i] = '\\';
+			esc[2*i+1] = str[i];
+		}
+		esc[2*i] = 0;
+		if (!str[i] && fnmatch(esc, str, 0))
+			t_error("fnmatch(\"%s\", \"%s\", 0) did not match\n", esc, str);
+	}
+	return (unsigned long)strlen(str) << 16 | (r == 0) << 8 | (r2 == 0) << 4 | fl;
+}
+
+#ifndef T_FUZZREPRO
+int main(int argc, char *argv[])
+{
+	static const char *const dict[] = {
+		"*", "?", "[", "]", "[!a]", "[^a]", "[a-c]", "[]-]", "[[:alpha:]]", "[[:space:]]", "[[.a.]]",
+		"[[=a=]]", "\\", "/", ".", "*/", "/.", "\1", "**", 0
+	};
+	static const char *const seed[] = {
+		"\010a*b\1axxb", "\2*/*.c\1dir/x.c", "\4*\1.hidden", "\010[a-]z\1-z", "\1\\*\1\\x", "\010abc\1abc", 0
+	};
+	static const struct t_fuzz z = {__FILE__, run, dict, seed, 128};
+
+	return t_fuzz(&z, argc, argv);
+}
+#endif
@@ -0,0 +1,110 @@
+// glob: patterns under a small directory tree, the first byte selects
+// the flags, the results must be under the tree and sorted without
+// GLOB_NOSORT, GLOB_NOCHECK must return the pattern if nothing matched
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <glob.h>
+#include <sys/stat.h>
+#include "test.h"
+
+static const char *const tree[] = {"a", "b.c", ".h", "[x]", "d/", "d/e", "d/f.c", "d/.g", "d/d/", "d/d/a*", 0};
+static char dir[] = "/tmp/fuzz-glob-XXXXXX";
+
+static void cleanup(void)
+{
+	char buf[64];
+	int i;
+
+	for (i = 0; tree[i]; i++);
+	while (i--) {
+		snprintf(buf, sizeof buf, "%s/%s", dir, tree[i]);
+		if (remove(buf))
+			t_error("remove %s failed\n", buf);
+	}
+	rmdir(dir);
+}
+
+static int setup(void)
+{
+	char buf[64];
+	int i, fd;
+
+	if (!mkdtemp(dir)) {
+		t_error("mkdtemp failed\n");
+		return -1;
+	}
+	for (i = 0; tree[i]; i++) {
+		snprintf(buf, sizeof buf, "%s/%s", dir, tree[i]);
+		if (buf[strlen(buf)-1] == '/') {
+			mkdir(buf, 0755);
+		} else if ((fd = open(buf, O_WRONLY|O_CREAT|O_EXCL, 0644)) >= 0) {
+			close(fd);
+		}
+	}
+	atexit(cleanup);
+	return 0;
+}
+
+static unsigned long run(const unsigned char *p, size_t n)
+{
+	static const int flag[] = {GLOB_MARK, GLOB_NOCHECK, GLOB_NOESCAPE, GLOB_ERR, GLOB_NOSORT};
+	static int init;
+	char pat[256];
+	glob_t g;
+	size_t i, len;
+	int fl = 0, r;
+
+	if (!init) {
+		init = 1;
+		if (setup())
+			return 0;
+	}
+	if (!n)
+		return 0;
+	for (i = 0; i < sizeof flag / sizeof *flag; i++)
+		if (p[0] >> i & 1)
+			fl |= flag[i];
+	/* stay under the tree */
+	if (strstr((const char *)p + 1, ".."))
+		return 1;
+	snprintf(pat, sizeof pat, "%s/%s", dir, (const char *)p + 1);
+	len = strlen(dir) + 1;
+
+	r = glob(pat, fl, 0, &g);
+	if (r == 0) {
+		for (i = 0; i < g.gl_pathc; i++) {
+			if (strncmp(g.gl_pathv[i], pat, len))
+				t_error("glob(\"%s\", %#x) returned \"%s\"\n", pat, fl, g.gl_pathv[i]);
+			if (!(fl & GLOB_NOSORT) && i && strcmp(g.gl_pathv[i-1], g.gl_pathv[i]) >= 0)
+				t_error("glob(\"%s\", %#x) results are not sorted: \"%s\", \"%s\"\n",
+					pat, fl, g.gl_pathv[i-1], g.gl_pathv[i]);
+		}
+		if (g.gl_pathv[g.gl_pathc])
+			t_error("glob(\"%s\", %#x) result list is not terminated\n", pat, fl);
+	}
+	if (r == GLOB_NOMATCH && (fl & GLOB_NOCHECK))
+		t_error("glob(\"%s\", %#x) = GLOB_NOMATCH with GLOB_NOCHECK\n", pat, fl);
+	i = r ? 0 : g.gl_pathc;
+	if (r == 0)
+		globfree(&g);
+	return (unsigned long)i << 16 | (r & 255) << 8 | fl;
+}
+
+#ifndef T_FUZZREPRO
+int main(int argc, char *argv[])
+{
+	static const char *const dict[] = {
+		"*", "?", "[", "]", "[!a]", "[a-c]", "[[:alpha:]]", "\\", "/", "//", "*/*", ".*", "d", "a", "[x]",
+		"\\[x]", "*.c", "d/d/a\\*", 0
+	};
+	static const char *const seed[] = {
+		"\040*", "\041*/*", "\040.*", "\042nothing", "\040\\[x]", "\044[[]x]", "\040d/*/*", "\060*.c", 0
+	};
+	static const struct t_fuzz z = {__FILE__, run, dict, seed, 96};
+
+	return t_fuzz(&z, argc, argv);
+}
+#endif
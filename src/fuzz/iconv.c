@@ -0,0 +1,100 @@
+// iconv: the first byte selects the charsets, converting with a 4 byte
+// output buffer at a time must give the same output, error and consumed
+// input as with a large buffer, utf-8 input converted to a unicode
+// encoding and back must be unchanged
+#include <string.h>
+#include <errno.h>
+#include <iconv.h>
+#include "test.h"
+
+/* the first NTO are also the targets */
+static const char *const cs[] = {
+	"UTF-8", "UTF-16LE", "UTF-16BE", "UTF-32LE", "ISO-8859-1", "WINDOWS-1252", "KOI8-R", "ASCII",
+	"SHIFT_JIS", "EUC-JP", "ISO-2022-JP", "GB18030", "BIG5", "EUC-KR", "UTF-16", "UCS-2",
+};
+enum {NCS = sizeof cs / sizeof *cs, NTO = 4, MAXIN = 256};
+static iconv_t cd[NCS][NTO];
+static char opened[NCS][NTO];
+
+static iconv_t get(int from, int to)
+{
+	if (!opened[from][to]) {
+		opened[from][to] = 1;
+		cd[from][to] = iconv_open(cs[to], cs[from]);
+	}
+	return cd[from][to];
+}
+
+/* output size, *used is the consumed input and *err the errno of a failure or 0 */
+static size_t conv(iconv_t c, const unsigned char *in, size_t n, char *out, size_t size, size_t chunk, size_t *used, int *err)
+{
+	char *i = (char *)in, *o;
+	size_t il = n, ol, total = 0, prev, r;
+
+	iconv(c, 0, 0, 0, 0);
+	*err = 0;
+	for (;;) {
+		prev = total;
+		o = out + total;
+		ol = size - total < chunk ? size - total : chunk;
+		r = iconv(c, &i, &il, &o, &ol);
+		total = o - out;
+		if (r != (size_t)-1)
+			break;
+		/* E2BIG without progress would loop forever */
+		if (errno != E2BIG || total == prev) {
+			*err = errno;
+			break;
+		}
+	}
+	*used = n - il;
+	return total;
+}
+
+static unsigned long run(const unsigned char *p, size_t n)
+{
+	char out[4*MAXIN+16], out2[4*MAXIN+16], back[4*MAXIN+16];
+	size_t len, len2, lenb, used, used2, usedb;
+	int from, to, err, err2, errb;
+	iconv_t c, b;
+
+	if (!n)
+		return 0;
+	from = p[0] % NCS;
+	to = p[0] / NCS % NTO;
+	p++;
+	n--;
+	c = get(from, to);
+	if (c == (iconv_t)-1)
+		return 1;
+	len = conv(c, p, n, out, sizeof out, sizeof out, &used, &err);
+	len2 = conv(c, p, n, out2, sizeof out2, 4, &used2, &err2);
+	if (len != len2 || memcmp(out, out2, len) || used != used2 || err != err2)
+		t_error("iconv %s to %s of %d bytes: %d bytes from %d, errno %d, with 4 byte output steps %d bytes from %d, errno %d\n",
+			cs[from], cs[to], (int)n, (int)len, (int)used, err, (int)len2, (int)used2, err2);
+	if (from == 0 && to != 0 && !err && (b = get(to, 0)) != (iconv_t)-1) {
+		lenb = conv(b, (unsigned char *)out, len, back, sizeof back, sizeof back, &usedb, &errb);
+		if (errb || lenb != n || memcmp(back, p, n))
+			t_error("utf-8 input of %d bytes converted to %s and back gave %d bytes, errno %d\n",
+				(int)n, cs[to], (int)lenb, errb);
+	}
+	return (unsigned long)used << 20 | (unsigned long)len << 8 | (err & 15) << 4 | from;
+}
+
+#ifndef T_FUZZREPRO
+int main(int argc, char *argv[])
+{
+	static const char *const dict[] = {
+		"\303\251", "\342\202\254", "\360\237\230\200", "\355\240\200", "\300\200", "\364\220\200\200",
+		"\357\273\277", "\376\377", "\377\376", "\330\334", "\033$B", "\033(B", "\033(J", "\201\100",
+		"\217\242\257", "\201\060\201\060", "\244\100", 0
+	};
+	static const char *const seed[] = {
+		"\020caf\303\251 \342\202\254", "\060\303\251\360\237\230\200", "\112\033$B$\"\033(B", "\110\202\240\202\242",
+		"\113\201\060\201\060abc", "\114\244\100\244\101", "\115\260\241", "\104caf\351", "\116\377\376a", 0
+	};
+	static const struct t_fuzz z = {__FILE__, run, dict, seed, MAXIN};
+
+	return t_fuzz(&z, argc, argv);
+}
+#endif
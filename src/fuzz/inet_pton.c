@@ -0,0 +1,76 @@
+// inet_pton: the first byte selects the address family, AF_INET is
+// compared with a reference parser of the dotted decimal form and
+// addresses formatted with inet_ntop must parse back to the same bytes
+#include <string.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include "test.h"
+
+/* exactly four decimal parts of 0..255 without leading zeros */
+static int ref4(const char *s, unsigned char *a)
+{
+	int i, j, v;
+
+	for (i = 0; i < 4; i++) {
+		for (v = j = 0; s[j] >= '0' && s[j] <= '9'; j++) {
+			if (j && s[0] == '0')
+				return 0;
+			v = 10*v + s[j] - '0';
+			if (v > 255)
+				return 0;
+		}
+		if (!j)
+			return 0;
+		a[i] = v;
+		s += j;
+		if (i < 3 && *s++ != '.')
+			return 0;
+	}
+	return *s == 0;
+}
+
+static unsigned long run(const unsigned char *p, size_t n)
+{
+	const char *s = n ? (const char *)p + 1 : "";
+	int af = n && p[0] & 1 ? AF_INET6 : AF_INET;
+	unsigned char a[16], b[16], want[4];
+	char buf[INET6_ADDRSTRLEN], buf2[INET6_ADDRSTRLEN];
+	size_t size = af == AF_INET ? 4 : 16;
+	int r, w;
+
+	r = inet_pton(af, s, a);
+	if (af == AF_INET) {
+		w = ref4(s, want);
+		if (r != w || (r == 1 && memcmp(a, want, 4)))
+			t_error("inet_pton(AF_INET, \"%s\") = %d %u.%u.%u.%u, want %d %u.%u.%u.%u\n", s, r,
+				a[0], a[1], a[2], a[3], w, want[0], want[1], want[2], want[3]);
+	}
+	if (r != 1)
+		return r + 1;
+	if (!inet_ntop(af, a, buf, sizeof buf)) {
+		t_error("inet_ntop(%d) failed for the address of \"%s\"\n", af, s);
+		return 3;
+	}
+	if (inet_pton(af, buf, b) != 1 || memcmp(a, b, size))
+		t_error("inet_pton(%d, \"%s\") differs from the address of \"%s\" it was printed from\n", af, buf, s);
+	else if (!inet_ntop(af, b, buf2, sizeof buf2) || strcmp(buf, buf2))
+		t_error("inet_ntop(%d) printed \"%s\" and then \"%s\" for the same address\n", af, buf, buf2);
+	return (unsigned long)strlen(buf) << 8 | (unsigned long)strcspn(buf, ":.") << 2 | (af == AF_INET6);
+}
+
+#ifndef T_FUZZREPRO
+int main(int argc, char *argv[])
+{
+	static const char *const dict[] = {
+		".", ":", "::", "0", "255", "256", "00", "ffff", "FFFF", "0:0:0:0:0:0:", "::ffff:", "1.2.3.4",
+		"%", "0x1", " ", 0
+	};
+	static const char *const seed[] = {
+		"\0021.2.3.4", "\0020.0.0.0", "\002255.255.255.255", "\00301.2.3.4", "\003::", "\003::1",
+		"\0031:2:3:4:5:6:7:8", "\003::ffff:1.2.3.4", "\0031::2:0:0:3", "\0030:0:1::", 0
+	};
+	static const struct t_fuzz z = {__FILE__, run, dict, seed, 64};
+
+	return t_fuzz(&z, argc, argv);
+}
+#endif
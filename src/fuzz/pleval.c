@@ -0,0 +1,51 @@
+// __pleval: musl internal plural form expression evaluator used by
+// dcngettext, an expression must evaluate the same in parentheses, it is
+// evaluated for a few n, nothing is run where __pleval is not available
+#include <stdio.h>
+#include <string.h>
+#include "test.h"
+
+#pragma weak __pleval
+unsigned long __pleval(const char *, unsigned long);
+
+static unsigned long run(const unsigned char *p, size_t n)
+{
+	static const unsigned long v[] = {0, 1, 2, 5, 11, 100, -1};
+	const char *s = (const char *)p;
+	char buf[300];
+	unsigned long h = 0, r, r2;
+	int i;
+
+	if (!__pleval)
+		return 0;
+	snprintf(buf, sizeof buf, "(%s)", s);
+	for (i = 0; i < sizeof v / sizeof *v; i++) {
+		r = __pleval(s, v[i]);
+		r2 = __pleval(buf, v[i]);
+		if (r != -1 && r2 != -1 && r != r2)
+			t_error("__pleval(\"%s\", %lu) = %lu, in parentheses it is %lu\n", s, v[i], r, r2);
+		h = h * 31 + r;
+	}
+	return h;
+}
+
+#ifndef T_FUZZREPRO
+int main(int argc, char *argv[])
+{
+	static const char *const dict[] = {
+		"n", "(", ")", "?", ":", "||", "&&", "==", "!=", "<", ">", "<=", ">=", "+", "-", "*", "/", "%",
+		"!", "0", "1", "10", "100", "4294967295", ";", " ", 0
+	};
+	static const char *const seed[] = {
+		"n!=1;", "n==1 ? 0 : n==2 ? 1 : 2", "n%10==1 && n%100!=11 ? 0 : n%10>=2 && n%10<=4 && (n%100<10 || n%100>=20) ? 1 : 2",
+		"(n==0) ? 0 : (n==1) ? 1 : (n%100>=3 && n%100<=10) ? 3 : 5", "n/0", "!!!n", 0
+	};
+	static const struct t_fuzz z = {__FILE__, run, dict, seed, 256};
+
+	if (!__pleval) {
+		printf("%s: __pleval is not available\n", z.file);
+		return 0;
+	}
+	return t_fuzz(&z, argc, argv);
+}
+#endif
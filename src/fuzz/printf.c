@@ -0,0 +1,81 @@
+// printf: the input bytes make a double, a long and a precision, %a,
+// %.17g and %.*e with at least 17 digits must parse back exactly with
+// strtod, %ld with strtol, and snprintf into a short buffer must return
+// the same length as into a large one with a prefix of its output
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "test.h"
+
+static int same(double x, double y)
+{
+	return (x == y && !signbit(x) == !signbit(y)) || (isnan(x) && isnan(y));
+}
+
+static void back(const char *fmt, int prec, double x)
+{
+	char buf[128];
+	double y;
+
+	snprintf(buf, sizeof buf, fmt, prec, x);
+	y = strtod(buf, 0);
+	if (!same(x, y))
+		t_error("strtod(\"%s\") = %a, printed from %a with %s (precision %d)\n", buf, y, x, fmt, prec);
+}
+
+/* snprintf into a short buffer, returns the length */
+static int shortbuf(const char *fmt, int prec, double x)
+{
+	char buf[512], small[8];
+	int r, r2;
+
+	r = snprintf(buf, sizeof buf, fmt, prec, x);
+	r2 = snprintf(small, sizeof small, fmt, prec, x);
+	if (r != r2 || strlen(small) != (r < 8 ? r : 7) || strncmp(small, buf, 7))
+		t_error("snprintf(small, 8, \"%s\", %d, %a) = %d \"%s\", with a large buffer %d \"%s\"\n",
+			fmt, prec, x, r2, small, r, buf);
+	return r;
+}
+
+static unsigned long run(const unsigned char *p, size_t n)
+{
+	unsigned char b[17] = {0};
+	char buf[32];
+	double x;
+	long i;
+	int prec, lf, le;
+
+	memcpy(b, p, n < sizeof b ? n : sizeof b);
+	memcpy(&x, b, sizeof x);
+	memcpy(&i, b + 8, sizeof i);
+	prec = 16 + b[16] % 48;
+
+	back("%.*a", -1, x);
+	back("%.*g", 17, x);
+	back("%.*e", prec, x);
+	le = shortbuf("%.*e", prec, x);
+	lf = shortbuf("%.*f", b[16] % 32, x);
+	snprintf(buf, sizeof buf, "%ld", i);
+	if (strtol(buf, 0, 10) != i)
+		t_error("strtol(\"%s\") = %ld, printed from %ld\n", buf, strtol(buf, 0, 10), i);
+	return (unsigned long)lf << 16 | le << 8 | fpclassify(x) << 1 | !!signbit(x);
+}
+
+#ifndef T_FUZZREPRO
+int main(int argc, char *argv[])
+{
+	/* little endian DBL_MAX, a nan with payload, 1.0 and LONG_MIN */
+	static const char *const dict[] = {
+		"\377\377\377\377\377\377\357\177", "\1\1\1\1\1\1\370\377", "\360\077", "\200",
+		"\1\1\1\1\1\1\1\200", "\377\377\377\377", 0
+	};
+	static const char *const seed[] = {
+		"abcdefghijklmnopq", "\377\377\377\377\377\377\357\177", "\1\1\1\1\1\1\1\1\1\1\1\1\1\1\1\1\1",
+		"\232\231\231\231\231\231\271\077", 0
+	};
+	static const struct t_fuzz z = {__FILE__, run, dict, seed, 17};
+
+	return t_fuzz(&z, argc, argv);
+}
+#endif
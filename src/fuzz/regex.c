@@ -0,0 +1,73 @@
+// regcomp and regexec: the first byte selects the flags, a \1 byte
+// separates the pattern from the subject, a match must lie in the subject
+// and its submatches in the match, REG_NOSUB must give the same result
+#include <string.h>
+#include <regex.h>
+#include "test.h"
+
+static unsigned long run(const unsigned char *p, size_t n)
+{
+	static const int flag[] = {REG_EXTENDED, REG_ICASE, REG_NEWLINE};
+	const char *s, *sub;
+	char pat[256];
+	regex_t re;
+	regmatch_t m[10];
+	size_t len, slen, i;
+	int cf = 0, r, r2;
+
+	if (!n)
+		return 0;
+	for (i = 0; i < sizeof flag / sizeof *flag; i++)
+		if (p[0] >> i & 1)
+			cf |= flag[i];
+	s = (const char *)p + 1;
+	sub = strchr(s, '\1');
+	len = sub ? sub - s : strlen(s);
+	sub = sub ? sub + 1 : "";
+	if (len >= sizeof pat)
+		len = sizeof pat - 1;
+	memcpy(pat, s, len);
+	pat[len] = 0;
+	slen = strlen(sub);
+
+	r = regcomp(&re, pat, cf);
+	if (r)
+		return r << 4 | cf;
+	r2 = regexec(&re, sub, 10, m, 0);
+	if (r2 == 0) {
+		if (m[0].rm_so < 0 || m[0].rm_so > m[0].rm_eo || m[0].rm_eo > slen)
+			t_error("regexec(\"%s\", \"%s\", flags %d) matched [%d,%d)\n",
+				pat, sub, cf, (int)m[0].rm_so, (int)m[0].rm_eo);
+		for (i = 1; i < 10 && i <= re.re_nsub; i++)
+			if (m[i].rm_so != -1 && (m[i].rm_so < m[0].rm_so || m[i].rm_eo > m[0].rm_eo || m[i].rm_so > m[i].rm_eo))
+				t_error("regexec(\"%s\", \"%s\", flags %d) submatch %d [%d,%d) is outside the match [%d,%d)\n",
+					pat, sub, cf, (int)i, (int)m[i].rm_so, (int)m[i].rm_eo, (int)m[0].rm_so, (int)m[0].rm_eo);
+	}
+	i = re.re_nsub;
+	regfree(&re);
+	if (regcomp(&re, pat, cf|REG_NOSUB)) {
+		t_error("regcomp(\"%s\", flags %d) failed with REG_NOSUB only\n", pat, cf);
+	} else {
+		if ((regexec(&re, sub, 0, 0, 0) == 0) != (r2 == 0))
+			t_error("regexec(\"%s\", \"%s\", flags %d) = %d, with REG_NOSUB it differs\n", pat, sub, cf, r2);
+		regfree(&re);
+	}
+	return (unsigned long)(r2 == 0 ? m[0].rm_eo - m[0].rm_so + 1 : 0) << 16 | (i & 15) << 12 | (r2 == 0) << 8 | cf;
+}
+
+#ifndef T_FUZZREPRO
+int main(int argc, char *argv[])
+{
+	static const char *const dict[] = {
+		"\\(", "\\)", "(", ")", "*", "+", "?", "{1,3}", "\\{2\\}", "{,}", "[a-z]", "[[:alpha:]]",
+		"[^x]", "[]]", "[[.a.]]", "[[=a=]]", "[[.hyphen.]]", "^", "$", "|", "\\1", "\\9", ".", "\1", "\\", 0
+	};
+	static const char *const seed[] = {
+		"\2a*b\1aaab", "\1(a|b)+c\1abac", "\010\\(a*\\)\\1\1aaaa", "\1^[[:digit:]]{2,3}$\0012024",
+		"\3(A|b){1,2}x\1bAx", "\4a$\1a\nb", 0
+	};
+	static const struct t_fuzz z = {__FILE__, run, dict, seed, 96};
+
+	return t_fuzz(&z, argc, argv);
+}
+#endif
@@ -0,0 +1,58 @@
+// sscanf: %ld must agree with strtol and %lf with strtod, and a format
+// with many conversion types is run for crashes
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <math.h>
+#include "test.h"
+
+static int same(double x, double y)
+{
+	return (x == y && !signbit(x) == !signbit(y)) || (isnan(x) && isnan(y));
+}
+
+static unsigned long run(const unsigned char *p, size_t n)
+{
+	const char *s = (const char *)p;
+	char w[16], set[16], c, *e;
+	long a, b;
+	unsigned u;
+	double x, y;
+	int r, rf, rm, k = -1, m = -1, d, err;
+
+	r = sscanf(s, "%ld%n", &a, &k);
+	errno = 0;
+	b = strtol(s, &e, 10);
+	err = errno;
+	if (e != s && err != ERANGE && (r != 1 || a != b || k != e - s))
+		t_error("sscanf(\"%s\", \"%%ld%%n\") = %d, %ld, %d, strtol gave %ld consuming %d\n",
+			s, r, r == 1 ? a : 0, k, b, (int)(e - s));
+	if (e == s && r > 0)
+		t_error("sscanf(\"%s\", \"%%ld\") = %d, %ld, strtol found no number\n", s, r, a);
+
+	/* scanf cannot push back more than one byte, only successful conversions agree */
+	rf = sscanf(s, "%lf", &x);
+	y = strtod(s, &e);
+	if (rf == 1 && (e == s || !same(x, y)))
+		t_error("sscanf(\"%s\", \"%%lf\") = %a, strtod gave %a consuming %d\n", s, x, y, (int)(e - s));
+
+	rm = sscanf(s, "%d %x %15s %c %15[a-z0-9.] %lf %n", &d, &u, w, &c, set, &x, &m);
+	return (unsigned long)(r + 1) << 24 | (rf + 1) << 20 | (rm + 1) << 16 | (k & 255) << 8 | (m & 255);
+}
+
+#ifndef T_FUZZREPRO
+int main(int argc, char *argv[])
+{
+	static const char *const dict[] = {
+		"-", "+", " ", "0x", "1e", "e+", "nan", "inf", "infinity", ".", "9223372036854775807",
+		"9223372036854775808", "abc", "z9", "0x1p-3", 0
+	};
+	static const char *const seed[] = {
+		"42", " -17 rest", "12 ff word x abc 1.5 ", "1e+", "0x", "-nan", "infinit", 0
+	};
+	static const struct t_fuzz z = {__FILE__, run, dict, seed, 128};
+
+	return t_fuzz(&z, argc, argv);
+}
+#endif
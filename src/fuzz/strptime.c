@@ -0,0 +1,95 @@
+// strptime: the first byte selects one of the formats (1..8) or a format
+// taken from the input up to a \1 byte, the fields of a successful parse must
+// be in range and with the fixed formats strftime of the result must
+// parse back to the same fields, only for valid dates: %j 366 of a non leap
+// year or a %U or %W week past the end of the year is not a day of that year
+// and posix does not specify the result
+#define _XOPEN_SOURCE 700
+#include <string.h>
+#include <time.h>
+#include "test.h"
+
+static const char *const fmt[] = {
+	"%Y-%m-%d %H:%M:%S", "%a, %d %b %Y %T", "%D %R", "%I:%M:%S %p", "%Y %j", "%d %B %y", "%c", "%x %X",
+};
+#define NFMT (sizeof fmt / sizeof *fmt)
+
+static int inrange(const struct tm *tm)
+{
+	return tm->tm_mon >= 0 && tm->tm_mon <= 11 && tm->tm_mday >= 1 && tm->tm_mday <= 31 &&
+		tm->tm_hour >= 0 && tm->tm_hour <= 23 && tm->tm_min >= 0 && tm->tm_min <= 59 &&
+		tm->tm_sec >= 0 && tm->tm_sec <= 61 && tm->tm_wday >= 0 && tm->tm_wday <= 6 &&
+		tm->tm_yday >= 0 && tm->tm_yday <= 365;
+}
+
+static int valid(const struct tm *tm)
+{
+	int y = tm->tm_year + 1900;
+
+	return tm->tm_yday >= 0 && tm->tm_yday < 365 + (y%4 == 0 && (y%100 != 0 || y%400 == 0));
+}
+
+static int same(const struct tm *a, const struct tm *b)
+{
+	return a->tm_year == b->tm_year && a->tm_mon == b->tm_mon && a->tm_mday == b->tm_mday &&
+		a->tm_hour == b->tm_hour && a->tm_min == b->tm_min && a->tm_sec == b->tm_sec &&
+		a->tm_wday == b->tm_wday && a->tm_yday == b->tm_yday;
+}
+
+static unsigned long run(const unsigned char *p, size_t n)
+{
+	struct tm tm = {.tm_mday = 1}, tm2;
+	const char *s, *f;
+	char buf[256], pat[128];
+	size_t len;
+	char *e;
+
+	if (!n)
+		return 0;
+	s = (const char *)p + 1;
+	if (p[0] >= 1 && p[0] <= NFMT) {
+		f = fmt[p[0]-1];
+	} else {
+		e = strchr(s, '\1');
+		len = e ? e - s : strlen(s);
+		if (len >= sizeof pat)
+			len = sizeof pat - 1;
+		memcpy(pat, s, len);
+		pat[len] = 0;
+		f = pat;
+		s = e ? e + 1 : "";
+	}
+	e = strptime(s, f, &tm);
+	if (!e)
+		return f == pat ? 0 : p[0];
+	if (!valid(&tm))
+		return (unsigned long)(f == pat ? 0 : p[0]) << 8 | 2;
+	if (!inrange(&tm))
+		t_error("strptime(\"%s\", \"%s\") gave an out of range field: %d-%d-%d %d:%d:%d wday %d yday %d\n",
+			s, f, tm.tm_year, tm.tm_mon, tm.tm_mday, tm.tm_hour, tm.tm_min, tm.tm_sec, tm.tm_wday, tm.tm_yday);
+	else if (f != pat && strftime(buf, sizeof buf, f, &tm)) {
+		tm2 = tm;
+		if (!strptime(buf, f, &tm2) || !same(&tm, &tm2))
+			t_error("strptime(\"%s\", \"%s\") does not parse back the strftime output of \"%s\"\n", buf, f, s);
+	}
+	return (unsigned long)(e - s) << 16 | (unsigned long)(f == pat ? 0 : p[0]) << 8 | 1;
+}
+
+#ifndef T_FUZZREPRO
+int main(int argc, char *argv[])
+{
+	static const char *const dict[] = {
+		"%Y", "%m", "%d", "%e", "%H", "%I", "%M", "%S", "%p", "%j", "%a", "%A", "%b", "%B", "%y", "%C",
+		"%U", "%W", "%w", "%n", "%t", "%%", "%Ey", "%Od", "\1", "Jan", "February", "Mon", "PM", "12",
+		"60", "61", "366", "1999", " ", ":", 0
+	};
+	static const char *const seed[] = {
+		"\1" "2024-02-29 23:59:60", "\2Mon, 01 Jan 2001 00:00:00", "\3" "12/31/99 23:59", "\4" "12:00:00 AM",
+		"\5" "2000 366", "\6" "31 December 69", "\7Sun Feb 29 12:00:00 2004", "\10" "01/02/03 04:05:06",
+		"\20%Y %U %w\1" "2000 53 0", "\20%C%y %j\1" "2099 001", 0
+	};
+	static const struct t_fuzz z = {__FILE__, run, dict, seed, 128};
+
+	return t_fuzz(&z, argc, argv);
+}
+#endif
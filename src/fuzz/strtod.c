@@ -0,0 +1,72 @@
+// strtod: the consumed prefix must parse to the same value on its own and
+// a finite result printed with %a and %.17g must parse back exactly
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <math.h>
+#include "test.h"
+
+static int same(double x, double y)
+{
+	return (x == y && !signbit(x) == !signbit(y)) || (isnan(x) && isnan(y));
+}
+
+static void back(const char *fmt, double x)
+{
+	char buf[64];
+	double y;
+
+	snprintf(buf, sizeof buf, fmt, x);
+	y = strtod(buf, 0);
+	if (!same(x, y))
+		t_error("strtod(\"%s\") = %a, printed from %a with %s\n", buf, y, x, fmt);
+}
+
+static unsigned long run(const unsigned char *p, size_t n)
+{
+	const char *s = (const char *)p;
+	char buf[1024], *e, *e2;
+	double x, y;
+	int err, err2;
+
+	errno = 0;
+	x = strtod(s, &e);
+	err = errno;
+	if (e == s && x != 0)
+		t_error("strtod returned %a without consuming input\n", x);
+	if (e - s < sizeof buf) {
+		memcpy(buf, s, e - s);
+		buf[e - s] = 0;
+		errno = 0;
+		y = strtod(buf, &e2);
+		err2 = errno;
+		if (!same(x, y) || e2 != buf + (e - s) || err != err2)
+			t_error("strtod(\"%s\") = %a (errno %d), as a prefix it gave %a (errno %d) consuming %d bytes\n",
+				buf, y, err2, x, err, (int)(e - s));
+	}
+	if (isfinite(x)) {
+		back("%a", x);
+		back("%.17g", x);
+	}
+	return (unsigned long)(e - s) << 8 | fpclassify(x) << 2 | (err == ERANGE) << 1 | !!signbit(x);
+}
+
+#ifndef T_FUZZREPRO
+int main(int argc, char *argv[])
+{
+	static const char *const dict[] = {
+		"0x", "e", "E", "p", "P", "inf", "infinity", "nan", "nan(", ")", ".", "-", "+",
+		"1e308", "1e-324", "0x1p-1074", "2.2250738585072011e-308", "9007199254740993",
+		"4.9406564584124654e-324", "1.7976931348623157e308", "00000000000000000000",
+		"99999999999999999999", "e-400", "e+400", " ", 0
+	};
+	static const char *const seed[] = {
+		"0", "1.5", "-0x1.8p3", "1e400", "nan(123)", "infinity", "  +.5e-3",
+		"2.4703282292062327e-324", "0x.0000000000001p-1022", 0
+	};
+	static const struct t_fuzz z = {__FILE__, run, dict, seed, 512};
+
+	return t_fuzz(&z, argc, argv);
+}
+#endif
@@ -0,0 +1,88 @@
+// strtol: differential test against a simple reference implementation,
+// the first byte selects the base (0 or 2..36), the rest is parsed
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <limits.h>
+#include "test.h"
+
+static int digit(int c)
+{
+	if (c >= '0' && c <= '9')
+		return c - '0';
+	if (c >= 'a' && c <= 'z')
+		return c - 'a' + 10;
+	if (c >= 'A' && c <= 'Z')
+		return c - 'A' + 10;
+	return 99;
+}
+
+static long ref(const char *s, const char **end, int base, int *err)
+{
+	const char *p = s;
+	unsigned long v = 0, lim;
+	int neg = 0, any = 0, over = 0, d;
+
+	*err = 0;
+	while (*p == ' ' || (*p >= '\t' && *p <= '\r'))
+		p++;
+	if (*p == '+' || *p == '-')
+		neg = *p++ == '-';
+	/* 0x without a hex digit after it is just 0 */
+	if ((base == 0 || base == 16) && p[0] == '0' && (p[1] == 'x' || p[1] == 'X') && digit(p[2]) < 16) {
+		p += 2;
+		base = 16;
+	} else if (base == 0) {
+		base = p[0] == '0' ? 8 : 10;
+	}
+	lim = neg ? (unsigned long)LONG_MAX + 1 : LONG_MAX;
+	for (; (d = digit(*p)) < base; p++) {
+		any = 1;
+		if (v > (lim - d) / base)
+			over = 1;
+		else
+			v = v * base + d;
+	}
+	*end = any ? p : s;
+	if (over) {
+		*err = ERANGE;
+		return neg ? LONG_MIN : LONG_MAX;
+	}
+	return neg ? (long)-v : (long)v;
+}
+
+static unsigned long run(const unsigned char *p, size_t n)
+{
+	const char *s = n ? (const char *)p + 1 : "", *want;
+	char *e;
+	int base = n ? p[0] % 37 : 10, err, wanterr;
+	long r, w;
+
+	if (base == 1)
+		base = 0;
+	errno = 0;
+	r = strtol(s, &e, base);
+	err = errno;
+	w = ref(s, &want, base, &wanterr);
+	if (r != w || e != want || err != wanterr)
+		t_error("strtol(\"%s\", &e, %d) = %ld, consumed %d, errno %d, want %ld, %d, %d\n",
+			s, base, r, (int)(e - s), err, w, (int)(want - s), wanterr);
+	return (unsigned long)(e - s) << 16 | base << 8 | (err == ERANGE) << 1 | (r < 0);
+}
+
+#ifndef T_FUZZREPRO
+int main(int argc, char *argv[])
+{
+	static const char *const dict[] = {
+		"0x", "0X", "-", "+", " ", "\t", "0", "z", "Z", "9223372036854775807",
+		"9223372036854775808", "-9223372036854775808", "18446744073709551616",
+		"zzzzzzzzzzzzz", "777777777777777777777", "1111111111111111111111111111111111111111111111111111111111111111", 0
+	};
+	static const char *const seed[] = {
+		"\n123", "\020 0x7fffffffffffffff", "J0x10", "J0777", "J-12", "\044zz", "\002-101", "\n-9223372036854775809", 0
+	};
+	static const struct t_fuzz z = {__FILE__, run, dict, seed, 128};
+
+	return t_fuzz(&z, argc, argv);
+}
+#endif
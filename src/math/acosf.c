@@ -1,44 +0,0 @@
-#include <stdint.h>
-#include <stdio.h>
-#include "mtest.h"
-
-static struct f_f t[] = {
-#include "ucb/acosf.h"
-#include "sanity/acosf.h"
-#include "special/acosf.h"
-
-};
-
-int main(void)
-{
-	#pragma STDC FENV_ACCESS ON
-	float y;
-	float d;
-	int e, i, err = 0;
-	struct f_f *p;
-
-	for (i = 0; i < sizeof t/sizeof *t; i++) {
-		p = t + i;
-
-		if (p->r < 0)
-			continue;
-		fesetround(p->r);
-		feclearexcept(FE_ALL_EXCEPT);
-		y = acosf(p->x);
-		e = fetestexcept(INEXACT|INVALID|DIVBYZERO|UNDERFLOW|OVERFLOW);
-
-		if (!checkexcept(e, p->e, p->r)) {
-			printf("%s:%d: bad fp exception: %s acosf(%a)=%a, want %s",
-				p->file, p->line, rstr(p->r), p->x, p->y, estr(p->e));
-			printf(" got %s\n", estr(e));
-			err++;
-		}
-		d = ulperrf(y, p->y, p->dy);
-		if (!checkulp(d, p->r)) {
-			printf("%s:%d: %s acosf(%a) want %a got %a ulperr %.3f = %a + %a\n",
-				p->file, p->line, rstr(p->r), p->x, p->y, y, d, d-p->dy, p->dy);
-			err++;
-		}
-	}
-	return !!err;
-}
@@ -1,46 +0,0 @@
-#include <stdint.h>
-#include <stdio.h>
-#include "mtest.h"
-
-static struct d_d t[] = {
-#include "sanity/acosh.h"
-#include "special/acosh.h"
-
-};
-
-int main(void)
-{
-	#pragma STDC FENV_ACCESS ON
-	double y;
-	float d;
-	int e, i, err = 0;
-	struct d_d *p;
-
-	for (i = 0; i < sizeof t/sizeof *t; i++) {
-		p = t + i;
-
-		if (p->r < 0)
-			continue;
-		fesetround(p->r);
-		feclearexcept(FE_ALL_EXCEPT);
-		y = acosh(p->x);
-		e = fetestexcept(INEXACT|INVALID|DIVBYZERO|UNDERFLOW|OVERFLOW);
-
-		if (!checkexcept(e, p->e, p->r)) {
-			printf("%s:%d: bad fp exception: %s acosh(%a)=%a, want %s",
-				p->file, p->line, rstr(p->r), p->x, p->y, estr(p->e));
-			printf(" got %s\n", estr(e));
-			err++;
-		}
-		d = ulperr(y, p->y, p->dy);
-		if (!checkulp(d, p->r)) {
-			if (fabsf(d) < 2.0f)
-				printf("X ");
-			else
-				err++;
-			printf("%s:%d: %s acosh(%a) want %a got %a ulperr %.3f = %a + %a\n",
-				p->file, p->line, rstr(p->r), p->x, p->y, y, d, d-p->dy, p->dy);
-		}
-	}
-	return !!err;
-}
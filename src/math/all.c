@@ -0,0 +1,1913 @@
+// table driven libm test: every function is registered with its
+// signature (the vector struct type), its vector headers and how strictly
+// it is checked, the vectors are mapped at runtime (see mvec_open) and the
+// functions are run in parallel threads, each thread has its own fenv.
+// -H writes ulp error statistics (see struct ustat) as csv, -S sets the
+// rounding mode and clears the exception flags before every call, -B
+// benchmarks the functions instead of testing them (see struct bin).
+// usage: all.exe [-j nthreads] [-H csvfile] [-S] [-B] [func..]
+#define _GNU_SOURCE 1
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "mtest.h"
+#include "test.h"
+
+/* not available everywhere, missing functions are reported as failures */
+double pow10(double);
+float pow10f(float);
+long double pow10l(long double);
+#pragma weak pow10
+#pragma weak pow10f
+#pragma weak pow10l
+#pragma weak exp10
+#pragma weak exp10f
+#pragma weak exp10l
+#pragma weak drem
+#pragma weak dremf
+#pragma weak scalb
+#pragma weak scalbf
+#pragma weak sincos
+#pragma weak sincosf
+#pragma weak sincosl
+#pragma weak lgamma_r
+#pragma weak lgammaf_r
+#pragma weak lgammal_r
+#pragma weak j0f
+#pragma weak j1f
+#pragma weak jnf
+#pragma weak y0f
+#pragma weak y1f
+#pragma weak ynf
+
+enum {
+	EXCALL = 1<<0,    /* all exception flags must match */
+	ORINEXACT = 1<<1, /* a missing inexact is accepted */
+	NOINEXACT = 1<<2, /* inexact is not checked unless CHECK_INEXACT */
+	XUFLOW = 1<<3,    /* exception mismatch with a tiny result is tolerated */
+	CR = 1<<4,        /* result must be correctly rounded */
+	ULP1 = 1<<5,      /* less than 1ulp error in RN */
+	RN2 = 1<<6,       /* at most 2ulp error in RN, other modes are not checked */
+	XNOTRN = 1<<7,    /* ulp errors are tolerated in non-nearest modes */
+	YNEG = 1<<8,      /* negative x gives nan or -inf (y0, y1, yn) */
+	ALLI = 1<<9,      /* the int result is checked even if invalid is raised */
+	IFIRST = 1<<10,   /* the int argument comes first (jn, yn) */
+	RESD = 1<<11,     /* the result is double (nexttoward) */
+	RESF = 1<<12,     /* the result is float (nexttowardf) */
+	SIGNGAM = 1<<13,  /* uses signgam so it cannot run in parallel */
+};
+
+struct fun {
+	char *name;
+	char *type;
+	void (*f)(void);
+	void (*sym)(void);
+	int flags;
+	float xulp;       /* ulp errors below this are tolerated (X) */
+	char *vec[5];
+};
+
+static int exceptok(const struct fun *f, int got, int want, int r)
+{
+	if (f->flags & NOINEXACT) {
+#if !defined CHECK_INEXACT && !defined CHECK_INEXACT_OMISSION
+		got |= INEXACT;
+		want |= INEXACT;
+#endif
+		return checkexceptall(got, want, r);
+	}
+	if (f->flags & ORINEXACT && (got|INEXACT) == want)
+		return 1;
+	if (f->flags & EXCALL)
+		return checkexceptall(got, want, r);
+	return checkexcept(got, want, r);
+}
+
+static int ulpok(const struct fun *f, float d, int r)
+{
+	if (f->flags & RN2)
+		return r != RN || fabsf(d) <= 2;
+	if (f->flags & ULP1 && r == RN && fabsf(d) >= 1)
+		return 0;
+	return checkulp(d, r);
+}
+
+static int tolerated(const struct fun *f, float d, int r)
+{
+	return fabsf(d) < f->xulp || (f->flags & XNOTRN && r != RN);
+}
+
+/*
+the rounding mode is only set when it changes (the vectors are grouped
+by mode, see mvec_open) and flags that exceptok ignores in the current
+mode are not cleared between calls, so usually no fenv call is needed
+between two calls. if exceptok fails while such stale flags are raised
+the call is repeated with clean flags, so the results are the same as
+with a clean fenv before every call, which -S forces.
+*/
+static int strict;
+
+struct fe {
+	const struct fun *f;
+	int init;
+	int r;
+	int keep;
+	int stale;
+};
+
+/* flags that exceptok ignores, a stale one cannot turn a failure into success */
+static int keepmask(const struct fun *f, int r)
+{
+	if (f->flags & EXCALL)
+		return 0;
+#if defined CHECK_INEXACT || defined CHECK_INEXACT_OMISSION
+	if (f->flags & NOINEXACT || r == RN)
+		return 0;
+#else
+	if (f->flags & NOINEXACT)
+		return INEXACT;
+#endif
+	if (r == RN || f->flags & ORINEXACT)
+		return INEXACT;
+	return INEXACT|UNDERFLOW;
+}
+
+/* the checks between the calls may raise flags too, so test them here */
+static void fe_set(struct fe *fe, int r)
+{
+	int e;
+
+	if (strict || !fe->init || r != fe->r) {
+		fesetround(r);
+		feclearexcept(FE_ALL_EXCEPT);
+		fe->init = 1;
+		fe->r = r;
+		fe->keep = strict ? 0 : keepmask(fe->f, r);
+		fe->stale = 0;
+		return;
+	}
+	e = fetestexcept(INEXACT|INVALID|DIVBYZERO|UNDERFLOW|OVERFLOW);
+	if (e & ~fe->keep)
+		feclearexcept(e & ~fe->keep);
+	fe->stale = e & fe->keep;
+}
+
+static int fe_get(struct fe *fe)
+{
+	return fetestexcept(INEXACT|INVALID|DIVBYZERO|UNDERFLOW|OVERFLOW);
+}
+
+/* 1 if the call has to be repeated because stale flags were raised */
+static int fe_retry(struct fe *fe)
+{
+	if (!fe->stale)
+		return 0;
+	feclearexcept(FE_ALL_EXCEPT);
+	return 1;
+}
+
+static int run_d_d(const struct fun *f, struct ustat *st, FILE *out)
+{
+	#pragma STDC FENV_ACCESS ON
+	double y;
+	int neg;
+	float d;
+	int e, ok, bad, err = 0;
+	struct d_d *p;
+	struct miter it;
+	struct fe fe = {.f = f};
+
+	minit(&it, "d_d", 0, 0, sizeof *p, __FILE__, (char **)f->vec);
+	while ((p = mnext(&it))) {
+		if (p->r < 0)
+			continue;
+		do {
+			fe_set(&fe, p->r);
+			y = ((double (*)(double))f->f)(p->x);
+			e = fe_get(&fe);
+		} while (!exceptok(f, e, p->e, p->r) && fe_retry(&fe));
+
+		if (!exceptok(f, e, p->e, p->r)) {
+			if (f->flags & XUFLOW && fabsl(y) < DBL_MIN && (e|INEXACT) == (INEXACT|UNDERFLOW))
+				fprintf(out, "X ");
+			else
+				err++;
+			fprintf(out, "%s:%d: bad fp exception: %s %s(%a)=%a, want %s",
+				p->file, p->line, rstr(p->r), f->name, p->x, p->y, estr(p->e));
+			fprintf(out, " got %s\n", estr(e));
+		}
+		d = ulperr(y, p->y, p->dy);
+		ustat_add(st, p->r, p->x, d);
+		ok = f->flags & CR ? checkcr(y, p->y, p->r) : ulpok(f, d, p->r);
+		neg = f->flags & YNEG && p->x < 0;
+		bad = neg && !isnan(y) && y != -inf;
+		if (bad || (!neg && !ok)) {
+			if (!bad && tolerated(f, d, p->r))
+				fprintf(out, "X ");
+			else
+				err++;
+			fprintf(out, "%s:%d: %s %s(%a) want %a got %a ulperr %.3f = %a + %a\n",
+				p->file, p->line, rstr(p->r), f->name, p->x, p->y, y, d, d-p->dy, p->dy);
+		}
+	}
+	return err + it.err;
+}
+
+static int run_f_f(const struct fun *f, struct ustat *st, FILE *out)
+{
+	#pragma STDC FENV_ACCESS ON
+	float y;
+	int neg;
+	float d;
+	int e, ok, bad, err = 0;
+	struct f_f *p;
+	struct miter it;
+	struct fe fe = {.f = f};
+
+	minit(&it, "f_f", 0, 0, sizeof *p, __FILE__, (char **)f->vec);
+	while ((p = mnext(&it))) {
+		if (p->r < 0)
+			continue;
+		do {
+			fe_set(&fe, p->r);
+			y = ((float (*)(float))f->f)(p->x);
+			e = fe_get(&fe);
+		} while (!exceptok(f, e, p->e, p->r) && fe_retry(&fe));
+
+		if (!exceptok(f, e, p->e, p->r)) {
+			if (f->flags & XUFLOW && fabsl(y) < FLT_MIN && (e|INEXACT) == (INEXACT|UNDERFLOW))
+				fprintf(out, "X ");
+			else
+				err++;
+			fprintf(out, "%s:%d: bad fp exception: %s %s(%a)=%a, want %s",
+				p->file, p->line, rstr(p->r), f->name, p->x, p->y, estr(p->e));
+			fprintf(out, " got %s\n", estr(e));
+		}
+		d = ulperrf(y, p->y, p->dy);
+		ustat_add(st, p->r, p->x, d);
+		ok = f->flags & CR ? checkcr(y, p->y, p->r) : ulpok(f, d, p->r);
+		neg = f->flags & YNEG && p->x < 0;
+		bad = neg && !isnan(y) && y != -inf;
+		if (bad || (!neg && !ok)) {
+			if (!bad && tolerated(f, d, p->r))
+				fprintf(out, "X ");
+			else
+				err++;
+			fprintf(out, "%s:%d: %s %s(%a) want %a got %a ulperr %.3f = %a + %a\n",
+				p->file, p->line, rstr(p->r), f->name, p->x, p->y, y, d, d-p->dy, p->dy);
+		}
+	}
+	return err + it.err;
+}
+
+static int run_l_l(const struct fun *f, struct ustat *st, FILE *out)
+{
+	#pragma STDC FENV_ACCESS ON
+	long double y;
+	int neg;
+	float d;
+	int e, ok, bad, err = 0;
+	struct l_l *p;
+	struct miter it;
+	struct fe fe = {.f = f};
+
+	minit(&it, "l_l", 0, 0, sizeof *p, __FILE__, (char **)f->vec);
+	while ((p = mnext(&it))) {
+		if (p->r < 0)
+			continue;
+		do {
+			fe_set(&fe, p->r);
+			y = ((long double (*)(long double))f->f)(p->x);
+			e = fe_get(&fe);
+		} while (!exceptok(f, e, p->e, p->r) && fe_retry(&fe));
+
+		if (!exceptok(f, e, p->e, p->r)) {
+			if (f->flags & XUFLOW && fabsl(y) < LDBL_MIN && (e|INEXACT) == (INEXACT|UNDERFLOW))
+				fprintf(out, "X ");
+			else
+				err++;
+			fprintf(out, "%s:%d: bad fp exception: %s %s(%La)=%La, want %s",
+				p->file, p->line, rstr(p->r), f->name, p->x, p->y, estr(p->e));
+			fprintf(out, " got %s\n", estr(e));
+		}
+		d = ulperrl(y, p->y, p->dy);
+		ustat_add(st, p->r, p->x, d);
+		ok = f->flags & CR ? checkcr(y, p->y, p->r) : ulpok(f, d, p->r);
+		neg = f->flags & YNEG && p->x < 0;
+		bad = neg && !isnan(y) && y != -inf;
+		if (bad || (!neg && !ok)) {
+			if (!bad && tolerated(f, d, p->r))
+				fprintf(out, "X ");
+			else
+				err++;
+			fprintf(out, "%s:%d: %s %s(%La) want %La got %La ulperr %.3f = %a + %a\n",
+				p->file, p->line, rstr(p->r), f->name, p->x, p->y, y, d, d-p->dy, p->dy);
+		}
+	}
+	return err + it.err;
+}
+
+static int run_dd_d(const struct fun *f, struct ustat *st, FILE *out)
+{
+	#pragma STDC FENV_ACCESS ON
+	double y;
+	float d;
+	int e, ok, err = 0;
+	struct dd_d *p;
+	struct miter it;
+	struct fe fe = {.f = f};
+
+	minit(&it, "dd_d", 0, 0, sizeof *p, __FILE__, (char **)f->vec);
+	while ((p = mnext(&it))) {
+		if (p->r < 0)
+			continue;
+		do {
+			fe_set(&fe, p->r);
+			y = ((double (*)(double, double))f->f)(p->x, p->x2);
+			e = fe_get(&fe);
+		} while (!exceptok(f, e, p->e, p->r) && fe_retry(&fe));
+
+		if (!exceptok(f, e, p->e, p->r)) {
+			if (f->flags & XUFLOW && fabsl(y) < DBL_MIN && (e|INEXACT) == (INEXACT|UNDERFLOW))
+				fprintf(out, "X ");
+			else
+				err++;
+			fprintf(out, "%s:%d: bad fp exception: %s %s(%a,%a)=%a, want %s",
+				p->file, p->line, rstr(p->r), f->name, p->x, p->x2, p->y, estr(p->e));
+			fprintf(out, " got %s\n", estr(e));
+		}
+		d = ulperr(y, p->y, p->dy);
+		ustat_add(st, p->r, p->x, d);
+		ok = f->flags & CR ? checkcr(y, p->y, p->r) : ulpok(f, d, p->r);
+		if (!ok) {
+			if (tolerated(f, d, p->r))
+				fprintf(out, "X ");
+			else
+				err++;
+			fprintf(out, "%s:%d: %s %s(%a,%a) want %a got %a ulperr %.3f = %a + %a\n",
+				p->file, p->line, rstr(p->r), f->name, p->x, p->x2, p->y, y, d, d-p->dy, p->dy);
+		}
+	}
+	return err + it.err;
+}
+
+static int run_ff_f(const struct fun *f, struct ustat *st, FILE *out)
+{
+	#pragma STDC FENV_ACCESS ON
+	float y;
+	float d;
+	int e, ok, err = 0;
+	struct ff_f *p;
+	struct miter it;
+	struct fe fe = {.f = f};
+
+	minit(&it, "ff_f", 0, 0, sizeof *p, __FILE__, (char **)f->vec);
+	while ((p = mnext(&it))) {
+		if (p->r < 0)
+			continue;
+		do {
+			fe_set(&fe, p->r);
+			y = ((float (*)(float, float))f->f)(p->x, p->x2);
+			e = fe_get(&fe);
+		} while (!exceptok(f, e, p->e, p->r) && fe_retry(&fe));
+
+		if (!exceptok(f, e, p->e, p->r)) {
+			if (f->flags & XUFLOW && fabsl(y) < FLT_MIN && (e|INEXACT) == (INEXACT|UNDERFLOW))
+				fprintf(out, "X ");
+			else
+				err++;
+			fprintf(out, "%s:%d: bad fp exception: %s %s(%a,%a)=%a, want %s",
+				p->file, p->line, rstr(p->r), f->name, p->x, p->x2, p->y, estr(p->e));
+			fprintf(out, " got %s\n", estr(e));
+		}
+		d = ulperrf(y, p->y, p->dy);
+		ustat_add(st, p->r, p->x, d);
+		ok = f->flags & CR ? checkcr(y, p->y, p->r) : ulpok(f, d, p->r);
+		if (!ok) {
+			if (tolerated(f, d, p->r))
+				fprintf(out, "X ");
+			else
+				err++;
+			fprintf(out, "%s:%d: %s %s(%a,%a) want %a got %a ulperr %.3f = %a + %a\n",
+				p->file, p->line, rstr(p->r), f->name, p->x, p->x2, p->y, y, d, d-p->dy, p->dy);
+		}
+	}
+	return err + it.err;
+}
+
+static int run_ll_l(const struct fun *f, struct ustat *st, FILE *out)
+{
+	#pragma STDC FENV_ACCESS ON
+	long double y;
+	float d;
+	int e, ok, err = 0;
+	struct ll_l *p;
+	struct miter it;
+	struct fe fe = {.f = f};
+
+	minit(&it, "ll_l", 0, 0, sizeof *p, __FILE__, (char **)f->vec);
+	while ((p = mnext(&it))) {
+		if (p->r < 0)
+			continue;
+		do {
+			fe_set(&fe, p->r);
+			y = ((long double (*)(long double, long double))f->f)(p->x, p->x2);
+			e = fe_get(&fe);
+		} while (!exceptok(f, e, p->e, p->r) && fe_retry(&fe));
+
+		if (!exceptok(f, e, p->e, p->r)) {
+			if (f->flags & XUFLOW && fabsl(y) < LDBL_MIN && (e|INEXACT) == (INEXACT|UNDERFLOW))
+				fprintf(out, "X ");
+			else
+				err++;
+			fprintf(out, "%s:%d: bad fp exception: %s %s(%La,%La)=%La, want %s",
+				p->file, p->line, rstr(p->r), f->name, p->x, p->x2, p->y, estr(p->e));
+			fprintf(out, " got %s\n", estr(e));
+		}
+		d = f->flags & RESD ? ulperr(y, p->y, p->dy) :
+		    f->flags & RESF ? ulperrf(y, p->y, p->dy) : ulperrl(y, p->y, p->dy);
+		ustat_add(st, p->r, p->x, d);
+		ok = f->flags & CR ? checkcr(y, p->y, p->r) : ulpok(f, d, p->r);
+		if (!ok) {
+			if (tolerated(f, d, p->r))
+				fprintf(out, "X ");
+			else
+				err++;
+			fprintf(out, "%s:%d: %s %s(%La,%La) want %La got %La ulperr %.3f = %a + %a\n",
+				p->file, p->line, rstr(p->r), f->name, p->x, p->x2, p->y, y, d, d-p->dy, p->dy);
+		}
+	}
+	return err + it.err;
+}
+
+static int run_ddd_d(const struct fun *f, struct ustat *st, FILE *out)
+{
+	#pragma STDC FENV_ACCESS ON
+	double y;
+	float d;
+	int e, ok, err = 0;
+	struct ddd_d *p;
+	struct miter it;
+	struct fe fe = {.f = f};
+
+	minit(&it, "ddd_d", 0, 0, sizeof *p, __FILE__, (char **)f->vec);
+	while ((p = mnext(&it))) {
+		if (p->r < 0)
+			continue;
+		do {
+			fe_set(&fe, p->r);
+			y = ((double (*)(double, double, double))f->f)(p->x, p->x2, p->x3);
+			e = fe_get(&fe);
+		} while (!exceptok(f, e, p->e, p->r) && fe_retry(&fe));
+
+		if (!exceptok(f, e, p->e, p->r)) {
+			if (f->flags & XUFLOW && fabsl(y) < DBL_MIN && (e|INEXACT) == (INEXACT|UNDERFLOW))
+				fprintf(out, "X ");
+			else
+				err++;
+			fprintf(out, "%s:%d: bad fp exception: %s %s(%a,%a,%a)=%a, want %s",
+				p->file, p->line, rstr(p->r), f->name, p->x, p->x2, p->x3, p->y, estr(p->e));
+			fprintf(out, " got %s\n", estr(e));
+		}
+		d = ulperr(y, p->y, p->dy);
+		ustat_add(st, p->r, p->x, d);
+		ok = f->flags & CR ? checkcr(y, p->y, p->r) : ulpok(f, d, p->r);
+		if (!ok) {
+			if (tolerated(f, d, p->r))
+				fprintf(out, "X ");
+			else
+				err++;
+			fprintf(out, "%s:%d: %s %s(%a,%a,%a) want %a got %a ulperr %.3f = %a + %a\n",
+				p->file, p->line, rstr(p->r), f->name, p->x, p->x2, p->x3, p->y, y, d, d-p->dy, p->dy);
+		}
+	}
+	return err + it.err;
+}
+
+static int run_fff_f(const struct fun *f, struct ustat *st, FILE *out)
+{
+	#pragma STDC FENV_ACCESS ON
+	float y;
+	float d;
+	int e, ok, err = 0;
+	struct fff_f *p;
+	struct miter it;
+	struct fe fe = {.f = f};
+
+	minit(&it, "fff_f", 0, 0, sizeof *p, __FILE__, (char **)f->vec);
+	while ((p = mnext(&it))) {
+		if (p->r < 0)
+			continue;
+		do {
+			fe_set(&fe, p->r);
+			y = ((float (*)(float, float, float))f->f)(p->x, p->x2, p->x3);
+			e = fe_get(&fe);
+		} while (!exceptok(f, e, p->e, p->r) && fe_retry(&fe));
+
+		if (!exceptok(f, e, p->e, p->r)) {
+			if (f->flags & XUFLOW && fabsl(y) < FLT_MIN && (e|INEXACT) == (INEXACT|UNDERFLOW))
+				fprintf(out, "X ");
+			else
+				err++;
+			fprintf(out, "%s:%d: bad fp exception: %s %s(%a,%a,%a)=%a, want %s",
+				p->file, p->line, rstr(p->r), f->name, p->x, p->x2, p->x3, p->y, estr(p->e));
+			fprintf(out, " got %s\n", estr(e));
+		}
+		d = ulperrf(y, p->y, p->dy);
+		ustat_add(st, p->r, p->x, d);
+		ok = f->flags & CR ? checkcr(y, p->y, p->r) : ulpok(f, d, p->r);
+		if (!ok) {
+			if (tolerated(f, d, p->r))
+				fprintf(out, "X ");
+			else
+				err++;
+			fprintf(out, "%s:%d: %s %s(%a,%a,%a) want %a got %a ulperr %.3f = %a + %a\n",
+				p->file, p->line, rstr(p->r), f->name, p->x, p->x2, p->x3, p->y, y, d, d-p->dy, p->dy);
+		}
+	}
+	return err + it.err;
+}
+
+static int run_lll_l(const struct fun *f, struct ustat *st, FILE *out)
+{
+	#pragma STDC FENV_ACCESS ON
+	long double y;
+	float d;
+	int e, ok, err = 0;
+	struct lll_l *p;
+	struct miter it;
+	struct fe fe = {.f = f};
+
+	minit(&it, "lll_l", 0, 0, sizeof *p, __FILE__, (char **)f->vec);
+	while ((p = mnext(&it))) {
+		if (p->r < 0)
+			continue;
+		do {
+			fe_set(&fe, p->r);
+			y = ((long double (*)(long double, long double, long double))f->f)(p->x, p->x2, p->x3);
+			e = fe_get(&fe);
+		} while (!exceptok(f, e, p->e, p->r) && fe_retry(&fe));
+
+		if (!exceptok(f, e, p->e, p->r)) {
+			if (f->flags & XUFLOW && fabsl(y) < LDBL_MIN && (e|INEXACT) == (INEXACT|UNDERFLOW))
+				fprintf(out, "X ");
+			else
+				err++;
+			fprintf(out, "%s:%d: bad fp exception: %s %s(%La,%La,%La)=%La, want %s",
+				p->file, p->line, rstr(p->r), f->name, p->x, p->x2, p->x3, p->y, estr(p->e));
+			fprintf(out, " got %s\n", estr(e));
+		}
+		d = ulperrl(y, p->y, p->dy);
+		ustat_add(st, p->r, p->x, d);
+		ok = f->flags & CR ? checkcr(y, p->y, p->r) : ulpok(f, d, p->r);
+		if (!ok) {
+			if (tolerated(f, d, p->r))
+				fprintf(out, "X ");
+			else
+				err++;
+			fprintf(out, "%s:%d: %s %s(%La,%La,%La) want %La got %La ulperr %.3f = %a + %a\n",
+				p->file, p->line, rstr(p->r), f->name, p->x, p->x2, p->x3, p->y, y, d, d-p->dy, p->dy);
+		}
+	}
+	return err + it.err;
+}
+
+static int run_di_d(const struct fun *f, struct ustat *st, FILE *out)
+{
+	#pragma STDC FENV_ACCESS ON
+	double y;
+	int neg;
+	char a[128];
+	float d;
+	int e, ok, bad, err = 0;
+	struct di_d *p;
+	struct miter it;
+	struct fe fe = {.f = f};
+
+	minit(&it, "di_d", 0, 0, sizeof *p, __FILE__, (char **)f->vec);
+	while ((p = mnext(&it))) {
+		if (p->r < 0)
+			continue;
+		do {
+			fe_set(&fe, p->r);
+			y = ((double (*)(double, long long))f->f)(p->x, p->i);
+			e = fe_get(&fe);
+		} while (!exceptok(f, e, p->e, p->r) && fe_retry(&fe));
+		if (f->flags & IFIRST)
+			snprintf(a, sizeof a, "%lld, %a", p->i, p->x);
+		else
+			snprintf(a, sizeof a, "%a, %lld", p->x, p->i);
+
+		if (!exceptok(f, e, p->e, p->r)) {
+			if (f->flags & XUFLOW && fabsl(y) < DBL_MIN && (e|INEXACT) == (INEXACT|UNDERFLOW))
+				fprintf(out, "X ");
+			else
+				err++;
+			fprintf(out, "%s:%d: bad fp exception: %s %s(%s)=%a, want %s",
+				p->file, p->line, rstr(p->r), f->name, a, p->y, estr(p->e));
+			fprintf(out, " got %s\n", estr(e));
+		}
+		d = ulperr(y, p->y, p->dy);
+		ustat_add(st, p->r, p->x, d);
+		ok = f->flags & CR ? checkcr(y, p->y, p->r) : ulpok(f, d, p->r);
+		neg = f->flags & YNEG && p->x < 0;
+		bad = neg && !isnan(y) && y != -inf;
+		if (bad || (!neg && !ok)) {
+			if (!bad && tolerated(f, d, p->r))
+				fprintf(out, "X ");
+			else
+				err++;
+			fprintf(out, "%s:%d: %s %s(%s) want %a got %a, ulperr %.3f = %a + %a\n",
+				p->file, p->line, rstr(p->r), f->name, a, p->y, y, d, d-p->dy, p->dy);
+		}
+	}
+	return err + it.err;
+}
+
+static int run_fi_f(const struct fun *f, struct ustat *st, FILE *out)
+{
+	#pragma STDC FENV_ACCESS ON
+	float y;
+	int neg;
+	char a[128];
+	float d;
+	int e, ok, bad, err = 0;
+	struct fi_f *p;
+	struct miter it;
+	struct fe fe = {.f = f};
+
+	minit(&it, "fi_f", 0, 0, sizeof *p, __FILE__, (char **)f->vec);
+	while ((p = mnext(&it))) {
+		if (p->r < 0)
+			continue;
+		do {
+			fe_set(&fe, p->r);
+			y = ((float (*)(float, long long))f->f)(p->x, p->i);
+			e = fe_get(&fe);
+		} while (!exceptok(f, e, p->e, p->r) && fe_retry(&fe));
+		if (f->flags & IFIRST)
+			snprintf(a, sizeof a, "%lld, %a", p->i, p->x);
+		else
+			snprintf(a, sizeof a, "%a, %lld", p->x, p->i);
+
+		if (!exceptok(f, e, p->e, p->r)) {
+			if (f->flags & XUFLOW && fabsl(y) < FLT_MIN && (e|INEXACT) == (INEXACT|UNDERFLOW))
+				fprintf(out, "X ");
+			else
+				err++;
+			fprintf(out, "%s:%d: bad fp exception: %s %s(%s)=%a, want %s",
+				p->file, p->line, rstr(p->r), f->name, a, p->y, estr(p->e));
+			fprintf(out, " got %s\n", estr(e));
+		}
+		d = ulperrf(y, p->y, p->dy);
+		ustat_add(st, p->r, p->x, d);
+		ok = f->flags & CR ? checkcr(y, p->y, p->r) : ulpok(f, d, p->r);
+		neg = f->flags & YNEG && p->x < 0;
+		bad = neg && !isnan(y) && y != -inf;
+		if (bad || (!neg && !ok)) {
+			if (!bad && tolerated(f, d, p->r))
+				fprintf(out, "X ");
+			else
+				err++;
+			fprintf(out, "%s:%d: %s %s(%s) want %a got %a, ulperr %.3f = %a + %a\n",
+				p->file, p->line, rstr(p->r), f->name, a, p->y, y, d, d-p->dy, p->dy);
+		}
+	}
+	return err + it.err;
+}
+
+static int run_li_l(const struct fun *f, struct ustat *st, FILE *out)
+{
+	#pragma STDC FENV_ACCESS ON
+	long double y;
+	int neg;
+	char a[128];
+	float d;
+	int e, ok, bad, err = 0;
+	struct li_l *p;
+	struct miter it;
+	struct fe fe = {.f = f};
+
+	minit(&it, "li_l", 0, 0, sizeof *p, __FILE__, (char **)f->vec);
+	while ((p = mnext(&it))) {
+		if (p->r < 0)
+			continue;
+		do {
+			fe_set(&fe, p->r);
+			y = ((long double (*)(long double, long long))f->f)(p->x, p->i);
+			e = fe_get(&fe);
+		} while (!exceptok(f, e, p->e, p->r) && fe_retry(&fe));
+		if (f->flags & IFIRST)
+			snprintf(a, sizeof a, "%lld, %La", p->i, p->x);
+		else
+			snprintf(a, sizeof a, "%La, %lld", p->x, p->i);
+
+		if (!exceptok(f, e, p->e, p->r)) {
+			if (f->flags & XUFLOW && fabsl(y) < LDBL_MIN && (e|INEXACT) == (INEXACT|UNDERFLOW))
+				fprintf(out, "X ");
+			else
+				err++;
+			fprintf(out, "%s:%d: bad fp exception: %s %s(%s)=%La, want %s",
+				p->file, p->line, rstr(p->r), f->name, a, p->y, estr(p->e));
+			fprintf(out, " got %s\n", estr(e));
+		}
+		d = ulperrl(y, p->y, p->dy);
+		ustat_add(st, p->r, p->x, d);
+		ok = f->flags & CR ? checkcr(y, p->y, p->r) : ulpok(f, d, p->r);
+		neg = f->flags & YNEG && p->x < 0;
+		bad = neg && !isnan(y) && y != -inf;
+		if (bad || (!neg && !ok)) {
+			if (!bad && tolerated(f, d, p->r))
+				fprintf(out, "X ");
+			else
+				err++;
+			fprintf(out, "%s:%d: %s %s(%s) want %La got %La, ulperr %.3f = %a + %a\n",
+				p->file, p->line, rstr(p->r), f->name, a, p->y, y, d, d-p->dy, p->dy);
+		}
+	}
+	return err + it.err;
+}
+
+static int run_d_di(const struct fun *f, struct ustat *st, FILE *out)
+{
+	#pragma STDC FENV_ACCESS ON
+	double y;
+	long long yi;
+	int neg = 0;
+	float d;
+	int e, ok, bad, err = 0;
+	struct d_di *p;
+	struct miter it;
+	struct fe fe = {.f = f};
+
+	minit(&it, "d_di", 0, 0, sizeof *p, __FILE__, (char **)f->vec);
+	while ((p = mnext(&it))) {
+		if (p->r < 0)
+			continue;
+		do {
+			fe_set(&fe, p->r);
+			y = ((double (*)(double, long long *))f->f)(p->x, &yi);
+			e = fe_get(&fe);
+		} while (!exceptok(f, e, p->e, p->r) && fe_retry(&fe));
+
+		if (!exceptok(f, e, p->e, p->r)) {
+			if (f->flags & XUFLOW && fabsl(y) < DBL_MIN && (e|INEXACT) == (INEXACT|UNDERFLOW))
+				fprintf(out, "X ");
+			else
+				err++;
+			fprintf(out, "%s:%d: bad fp exception: %s %s(%a)=%a,%lld, want %s",
+				p->file, p->line, rstr(p->r), f->name, p->x, p->y, p->i, estr(p->e));
+			fprintf(out, " got %s\n", estr(e));
+		}
+		d = ulperr(y, p->y, p->dy);
+		ustat_add(st, p->r, p->x, d);
+		ok = f->flags & CR ? checkcr(y, p->y, p->r) : ulpok(f, d, p->r);
+		/* frexp: the exponent, lgamma: the sign of gamma */
+		if (f->flags & CR)
+			bad = isfinite(p->x) && yi != p->i;
+		else
+			bad = !isnan(p->x) && p->x != -inf && !(p->e&DIVBYZERO) && yi != p->i;
+		if (bad || (!neg && !ok)) {
+			if (!bad && tolerated(f, d, p->r))
+				fprintf(out, "X ");
+			else
+				err++;
+			fprintf(out, "%s:%d: %s %s(%a) want %a,%lld got %a,%lld ulperr %.3f = %a + %a\n",
+				p->file, p->line, rstr(p->r), f->name, p->x, p->y, p->i, y, yi, d, d-p->dy, p->dy);
+		}
+	}
+	return err + it.err;
+}
+
+static int run_f_fi(const struct fun *f, struct ustat *st, FILE *out)
+{
+	#pragma STDC FENV_ACCESS ON
+	float y;
+	long long yi;
+	int neg = 0;
+	float d;
+	int e, ok, bad, err = 0;
+	struct f_fi *p;
+	struct miter it;
+	struct fe fe = {.f = f};
+
+	minit(&it, "f_fi", 0, 0, sizeof *p, __FILE__, (char **)f->vec);
+	while ((p = mnext(&it))) {
+		if (p->r < 0)
+			continue;
+		do {
+			fe_set(&fe, p->r);
+			y = ((float (*)(float, long long *))f->f)(p->x, &yi);
+			e = fe_get(&fe);
+		} while (!exceptok(f, e, p->e, p->r) && fe_retry(&fe));
+
+		if (!exceptok(f, e, p->e, p->r)) {
+			if (f->flags & XUFLOW && fabsl(y) < FLT_MIN && (e|INEXACT) == (INEXACT|UNDERFLOW))
+				fprintf(out, "X ");
+			else
+				err++;
+			fprintf(out, "%s:%d: bad fp exception: %s %s(%a)=%a,%lld, want %s",
+				p->file, p->line, rstr(p->r), f->name, p->x, p->y, p->i, estr(p->e));
+			fprintf(out, " got %s\n", estr(e));
+		}
+		d = ulperrf(y, p->y, p->dy);
+		ustat_add(st, p->r, p->x, d);
+		ok = f->flags & CR ? checkcr(y, p->y, p->r) : ulpok(f, d, p->r);
+		/* frexp: the exponent, lgamma: the sign of gamma */
+		if (f->flags & CR)
+			bad = isfinite(p->x) && yi != p->i;
+		else
+			bad = !isnan(p->x) && p->x != -inf && !(p->e&DIVBYZERO) && yi != p->i;
+		if (bad || (!neg && !ok)) {
+			if (!bad && tolerated(f, d, p->r))
+				fprintf(out, "X ");
+			else
+				err++;
+			fprintf(out, "%s:%d: %s %s(%a) want %a,%lld got %a,%lld ulperr %.3f = %a + %a\n",
+				p->file, p->line, rstr(p->r), f->name, p->x, p->y, p->i, y, yi, d, d-p->dy, p->dy);
+		}
+	}
+	return err + it.err;
+}
+
+static int run_l_li(const struct fun *f, struct ustat *st, FILE *out)
+{
+	#pragma STDC FENV_ACCESS ON
+	long double y;
+	long long yi;
+	int neg = 0;
+	float d;
+	int e, ok, bad, err = 0;
+	struct l_li *p;
+	struct miter it;
+	struct fe fe = {.f = f};
+
+	minit(&it, "l_li", 0, 0, sizeof *p, __FILE__, (char **)f->vec);
+	while ((p = mnext(&it))) {
+		if (p->r < 0)
+			continue;
+		do {
+			fe_set(&fe, p->r);
+			y = ((long double (*)(long double, long long *))f->f)(p->x, &yi);
+			e = fe_get(&fe);
+		} while (!exceptok(f, e, p->e, p->r) && fe_retry(&fe));
+
+		if (!exceptok(f, e, p->e, p->r)) {
+			if (f->flags & XUFLOW && fabsl(y) < LDBL_MIN && (e|INEXACT) == (INEXACT|UNDERFLOW))
+				fprintf(out, "X ");
+			else
+				err++;
+			fprintf(out, "%s:%d: bad fp exception: %s %s(%La)=%La,%lld, want %s",
+				p->file, p->line, rstr(p->r), f->name, p->x, p->y, p->i, estr(p->e));
+			fprintf(out, " got %s\n", estr(e));
+		}
+		d = ulperrl(y, p->y, p->dy);
+		ustat_add(st, p->r, p->x, d);
+		ok = f->flags & CR ? checkcr(y, p->y, p->r) : ulpok(f, d, p->r);
+		/* frexp: the exponent, lgamma: the sign of gamma */
+		if (f->flags & CR)
+			bad = isfinite(p->x) && yi != p->i;
+		else
+			bad = !isnan(p->x) && p->x != -inf && !(p->e&DIVBYZERO) && yi != p->i;
+		if (bad || (!neg && !ok)) {
+			if (!bad && tolerated(f, d, p->r))
+				fprintf(out, "X ");
+			else
+				err++;
+			fprintf(out, "%s:%d: %s %s(%La) want %La,%lld got %La,%lld ulperr %.3f = %a + %a\n",
+				p->file, p->line, rstr(p->r), f->name, p->x, p->y, p->i, y, yi, d, d-p->dy, p->dy);
+		}
+	}
+	return err + it.err;
+}
+
+static int run_d_i(const struct fun *f, struct ustat *st, FILE *out)
+{
+	#pragma STDC FENV_ACCESS ON
+	long long y;
+	int e, err = 0;
+	struct d_i *p;
+	struct miter it;
+	struct fe fe = {.f = f};
+
+	minit(&it, "d_i", 0, 0, sizeof *p, __FILE__, (char **)f->vec);
+	while ((p = mnext(&it))) {
+		if (p->r < 0)
+			continue;
+		do {
+			fe_set(&fe, p->r);
+			y = ((long long (*)(double))f->f)(p->x);
+			e = fe_get(&fe);
+		} while (!exceptok(f, e, p->e, p->r) && fe_retry(&fe));
+
+		if (!exceptok(f, e, p->e, p->r)) {
+			if (f->flags & XUFLOW && fabsl(y) < DBL_MIN && (e|INEXACT) == (INEXACT|UNDERFLOW))
+				fprintf(out, "X ");
+			else
+				err++;
+			fprintf(out, "%s:%d: bad fp exception: %s %s(%a)=%lld, want %s",
+				p->file, p->line, rstr(p->r), f->name, p->x, p->i, estr(p->e));
+			fprintf(out, " got %s\n", estr(e));
+		}
+		if ((f->flags & ALLI || !(p->e&INVALID)) && y != p->i) {
+			fprintf(out, "%s:%d: %s %s(%a) want %lld got %lld\n",
+				p->file, p->line, rstr(p->r), f->name, p->x, p->i, y);
+			err++;
+		}
+	}
+	return err + it.err;
+}
+
+static int run_f_i(const struct fun *f, struct ustat *st, FILE *out)
+{
+	#pragma STDC FENV_ACCESS ON
+	long long y;
+	int e, err = 0;
+	struct f_i *p;
+	struct miter it;
+	struct fe fe = {.f = f};
+
+	minit(&it, "f_i", 0, 0, sizeof *p, __FILE__, (char **)f->vec);
+	while ((p = mnext(&it))) {
+		if (p->r < 0)
+			continue;
+		do {
+			fe_set(&fe, p->r);
+			y = ((long long (*)(float))f->f)(p->x);
+			e = fe_get(&fe);
+		} while (!exceptok(f, e, p->e, p->r) && fe_retry(&fe));
+
+		if (!exceptok(f, e, p->e, p->r)) {
+			if (f->flags & XUFLOW && fabsl(y) < FLT_MIN && (e|INEXACT) == (INEXACT|UNDERFLOW))
+				fprintf(out, "X ");
+			else
+				err++;
+			fprintf(out, "%s:%d: bad fp exception: %s %s(%a)=%lld, want %s",
+				p->file, p->line, rstr(p->r), f->name, p->x, p->i, estr(p->e));
+			fprintf(out, " got %s\n", estr(e));
+		}
+		if ((f->flags & ALLI || !(p->e&INVALID)) && y != p->i) {
+			fprintf(out, "%s:%d: %s %s(%a) want %lld got %lld\n",
+				p->file, p->line, rstr(p->r), f->name, p->x, p->i, y);
+			err++;
+		}
+	}
+	return err + it.err;
+}
+
+static int run_l_i(const struct fun *f, struct ustat *st, FILE *out)
+{
+	#pragma STDC FENV_ACCESS ON
+	long long y;
+	int e, err = 0;
+	struct l_i *p;
+	struct miter it;
+	struct fe fe = {.f = f};
+
+	minit(&it, "l_i", 0, 0, sizeof *p, __FILE__, (char **)f->vec);
+	while ((p = mnext(&it))) {
+		if (p->r < 0)
+			continue;
+		do {
+			fe_set(&fe, p->r);
+			y = ((long long (*)(long double))f->f)(p->x);
+			e = fe_get(&fe);
+		} while (!exceptok(f, e, p->e, p->r) && fe_retry(&fe));
+
+		if (!exceptok(f, e, p->e, p->r)) {
+			if (f->flags & XUFLOW && fabsl(y) < LDBL_MIN && (e|INEXACT) == (INEXACT|UNDERFLOW))
+				fprintf(out, "X ");
+			else
+				err++;
+			fprintf(out, "%s:%d: bad fp exception: %s %s(%La)=%lld, want %s",
+				p->file, p->line, rstr(p->r), f->name, p->x, p->i, estr(p->e));
+			fprintf(out, " got %s\n", estr(e));
+		}
+		if ((f->flags & ALLI || !(p->e&INVALID)) && y != p->i) {
+			fprintf(out, "%s:%d: %s %s(%La) want %lld got %lld\n",
+				p->file, p->line, rstr(p->r), f->name, p->x, p->i, y);
+			err++;
+		}
+	}
+	return err + it.err;
+}
+
+static int run_d_dd(const struct fun *f, struct ustat *st, FILE *out)
+{
+	#pragma STDC FENV_ACCESS ON
+	double y, y2;
+	float d2;
+	float d;
+	int e, ok, err = 0;
+	struct d_dd *p;
+	struct miter it;
+	struct fe fe = {.f = f};
+
+	minit(&it, "d_dd", 0, 0, sizeof *p, __FILE__, (char **)f->vec);
+	while ((p = mnext(&it))) {
+		if (p->r < 0)
+			continue;
+		do {
+			fe_set(&fe, p->r);
+			(((void (*)(double, double *, double *))f->f)(p->x, &y, &y2));
+			e = fe_get(&fe);
+		} while (!exceptok(f, e, p->e, p->r) && fe_retry(&fe));
+
+		if (!exceptok(f, e, p->e, p->r)) {
+			if (f->flags & XUFLOW && fabsl(y) < DBL_MIN && (e|INEXACT) == (INEXACT|UNDERFLOW))
+				fprintf(out, "X ");
+			else
+				err++;
+			fprintf(out, "%s:%d: bad fp exception: %s %s(%a)=%a,%a, want %s",
+				p->file, p->line, rstr(p->r), f->name, p->x, p->y, p->y2, estr(p->e));
+			fprintf(out, " got %s\n", estr(e));
+		}
+		d = ulperr(y, p->y, p->dy);
+		d2 = ulperr(y2, p->y2, p->dy2);
+		ustat_add(st, p->r, p->x, fabsf(d) > fabsf(d2) ? d : d2);
+		if (f->flags & CR)
+			ok = checkcr(y, p->y, p->r) && checkcr(y2, p->y2, p->r);
+		else
+			ok = ulpok(f, d, p->r) && ulpok(f, d2, p->r);
+		if (!ok) {
+			fprintf(out, "%s:%d: %s %s(%a) want %a,%a got %a,%a ulperr %.3f = %a + %a, %.3f = %a + %a\n",
+				p->file, p->line, rstr(p->r), f->name, p->x, p->y, p->y2, y, y2,
+				d, d-p->dy, p->dy, d2, d2-p->dy2, p->dy2);
+			err++;
+		}
+	}
+	return err + it.err;
+}
+
+static int run_f_ff(const struct fun *f, struct ustat *st, FILE *out)
+{
+	#pragma STDC FENV_ACCESS ON
+	float y, y2;
+	float d2;
+	float d;
+	int e, ok, err = 0;
+	struct f_ff *p;
+	struct miter it;
+	struct fe fe = {.f = f};
+
+	minit(&it, "f_ff", 0, 0, sizeof *p, __FILE__, (char **)f->vec);
+	while ((p = mnext(&it))) {
+		if (p->r < 0)
+			continue;
+		do {
+			fe_set(&fe, p->r);
+			(((void (*)(float, float *, float *))f->f)(p->x, &y, &y2));
+			e = fe_get(&fe);
+		} while (!exceptok(f, e, p->e, p->r) && fe_retry(&fe));
+
+		if (!exceptok(f, e, p->e, p->r)) {
+			if (f->flags & XUFLOW && fabsl(y) < FLT_MIN && (e|INEXACT) == (INEXACT|UNDERFLOW))
+				fprintf(out, "X ");
+			else
+				err++;
+			fprintf(out, "%s:%d: bad fp exception: %s %s(%a)=%a,%a, want %s",
+				p->file, p->line, rstr(p->r), f->name, p->x, p->y, p->y2, estr(p->e));
+			fprintf(out, " got %s\n", estr(e));
+		}
+		d = ulperrf(y, p->y, p->dy);
+		d2 = ulperrf(y2, p->y2, p->dy2);
+		ustat_add(st, p->r, p->x, fabsf(d) > fabsf(d2) ? d : d2);
+		if (f->flags & CR)
+			ok = checkcr(y, p->y, p->r) && checkcr(y2, p->y2, p->r);
+		else
+			ok = ulpok(f, d, p->r) && ulpok(f, d2, p->r);
+		if (!ok) {
+			fprintf(out, "%s:%d: %s %s(%a) want %a,%a got %a,%a ulperr %.3f = %a + %a, %.3f = %a + %a\n",
+				p->file, p->line, rstr(p->r), f->name, p->x, p->y, p->y2, y, y2,
+				d, d-p->dy, p->dy, d2, d2-p->dy2, p->dy2);
+			err++;
+		}
+	}
+	return err + it.err;
+}
+
+static int run_l_ll(const struct fun *f, struct ustat *st, FILE *out)
+{
+	#pragma STDC FENV_ACCESS ON
+	long double y, y2;
+	float d2;
+	float d;
+	int e, ok, err = 0;
+	struct l_ll *p;
+	struct miter it;
+	struct fe fe = {.f = f};
+
+	minit(&it, "l_ll", 0, 0, sizeof *p, __FILE__, (char **)f->vec);
+	while ((p = mnext(&it))) {
+		if (p->r < 0)
+			continue;
+		do {
+			fe_set(&fe, p->r);
+			(((void (*)(long double, long double *, long double *))f->f)(p->x, &y, &y2));
+			e = fe_get(&fe);
+		} while (!exceptok(f, e, p->e, p->r) && fe_retry(&fe));
+
+		if (!exceptok(f, e, p->e, p->r)) {
+			if (f->flags & XUFLOW && fabsl(y) < LDBL_MIN && (e|INEXACT) == (INEXACT|UNDERFLOW))
+				fprintf(out, "X ");
+			else
+				err++;
+			fprintf(out, "%s:%d: bad fp exception: %s %s(%La)=%La,%La, want %s",
+				p->file, p->line, rstr(p->r), f->name, p->x, p->y, p->y2, estr(p->e));
+			fprintf(out, " got %s\n", estr(e));
+		}
+		d = ulperrl(y, p->y, p->dy);
+		d2 = ulperrl(y2, p->y2, p->dy2);
+		ustat_add(st, p->r, p->x, fabsf(d) > fabsf(d2) ? d : d2);
+		if (f->flags & CR)
+			ok = checkcr(y, p->y, p->r) && checkcr(y2, p->y2, p->r);
+		else
+			ok = ulpok(f, d, p->r) && ulpok(f, d2, p->r);
+		if (!ok) {
+			fprintf(out, "%s:%d: %s %s(%La) want %La,%La got %La,%La ulperr %.3f = %a + %a, %.3f = %a + %a\n",
+				p->file, p->line, rstr(p->r), f->name, p->x, p->y, p->y2, y, y2,
+				d, d-p->dy, p->dy, d2, d2-p->dy2, p->dy2);
+			err++;
+		}
+	}
+	return err + it.err;
+}
+
+static int run_dd_di(const struct fun *f, struct ustat *st, FILE *out)
+{
+	#pragma STDC FENV_ACCESS ON
+	double y;
+	long long yi;
+	float d;
+	int e, err = 0;
+	struct dd_di *p;
+	struct miter it;
+	struct fe fe = {.f = f};
+
+	minit(&it, "dd_di", 0, 0, sizeof *p, __FILE__, (char **)f->vec);
+	while ((p = mnext(&it))) {
+		if (p->r < 0)
+			continue;
+		do {
+			fe_set(&fe, p->r);
+			y = ((double (*)(double, double, long long *))f->f)(p->x, p->x2, &yi);
+			e = fe_get(&fe);
+		} while (!exceptok(f, e, p->e, p->r) && fe_retry(&fe));
+
+		if (!exceptok(f, e, p->e, p->r)) {
+			if (f->flags & XUFLOW && fabsl(y) < DBL_MIN && (e|INEXACT) == (INEXACT|UNDERFLOW))
+				fprintf(out, "X ");
+			else
+				err++;
+			fprintf(out, "%s:%d: bad fp exception: %s %s(%a,%a)=%a,%lld, want %s",
+				p->file, p->line, rstr(p->r), f->name, p->x, p->x2, p->y, p->i, estr(p->e));
+			fprintf(out, " got %s\n", estr(e));
+		}
+		/* only the sign and the low 3 bits of the quotient are specified */
+		d = ulperr(y, p->y, p->dy);
+		ustat_add(st, p->r, p->x, d);
+		if (!checkcr(y, p->y, p->r) ||
+		    (!isnan(p->y) && (yi & 7) != (p->i & 7)) ||
+		    (!isnan(p->y) && (yi < 0) != (p->i < 0))) {
+			fprintf(out, "%s:%d: %s %s(%a,%a) want %a,%lld got %a,%lld ulperr %.3f = %a + %a\n",
+				p->file, p->line, rstr(p->r), f->name, p->x, p->x2, p->y, p->i, y, yi, d, d-p->dy, p->dy);
+			err++;
+		}
+	}
+	return err + it.err;
+}
+
+static int run_ff_fi(const struct fun *f, struct ustat *st, FILE *out)
+{
+	#pragma STDC FENV_ACCESS ON
+	float y;
+	long long yi;
+	float d;
+	int e, err = 0;
+	struct ff_fi *p;
+	struct miter it;
+	struct fe fe = {.f = f};
+
+	minit(&it, "ff_fi", 0, 0, sizeof *p, __FILE__, (char **)f->vec);
+	while ((p = mnext(&it))) {
+		if (p->r < 0)
+			continue;
+		do {
+			fe_set(&fe, p->r);
+			y = ((float (*)(float, float, long long *))f->f)(p->x, p->x2, &yi);
+			e = fe_get(&fe);
+		} while (!exceptok(f, e, p->e, p->r) && fe_retry(&fe));
+
+		if (!exceptok(f, e, p->e, p->r)) {
+			if (f->flags & XUFLOW && fabsl(y) < FLT_MIN && (e|INEXACT) == (INEXACT|UNDERFLOW))
+				fprintf(out, "X ");
+			else
+				err++;
+			fprintf(out, "%s:%d: bad fp exception: %s %s(%a,%a)=%a,%lld, want %s",
+				p->file, p->line, rstr(p->r), f->name, p->x, p->x2, p->y, p->i, estr(p->e));
+			fprintf(out, " got %s\n", estr(e));
+		}
+		/* only the sign and the low 3 bits of the quotient are specified */
+		d = ulperrf(y, p->y, p->dy);
+		ustat_add(st, p->r, p->x, d);
+		if (!checkcr(y, p->y, p->r) ||
+		    (!isnan(p->y) && (yi & 7) != (p->i & 7)) ||
+		    (!isnan(p->y) && (yi < 0) != (p->i < 0))) {
+			fprintf(out, "%s:%d: %s %s(%a,%a) want %a,%lld got %a,%lld ulperr %.3f = %a + %a\n",
+				p->file, p->line, rstr(p->r), f->name, p->x, p->x2, p->y, p->i, y, yi, d, d-p->dy, p->dy);
+			err++;
+		}
+	}
+	return err + it.err;
+}
+
+static int run_ll_li(const struct fun *f, struct ustat *st, FILE *out)
+{
+	#pragma STDC FENV_ACCESS ON
+	long double y;
+	long long yi;
+	float d;
+	int e, err = 0;
+	struct ll_li *p;
+	struct miter it;
+	struct fe fe = {.f = f};
+
+	minit(&it, "ll_li", 0, 0, sizeof *p, __FILE__, (char **)f->vec);
+	while ((p = mnext(&it))) {
+		if (p->r < 0)
+			continue;
+		do {
+			fe_set(&fe, p->r);
+			y = ((long double (*)(long double, long double, long long *))f->f)(p->x, p->x2, &yi);
+			e = fe_get(&fe);
+		} while (!exceptok(f, e, p->e, p->r) && fe_retry(&fe));
+
+		if (!exceptok(f, e, p->e, p->r)) {
+			if (f->flags & XUFLOW && fabsl(y) < LDBL_MIN && (e|INEXACT) == (INEXACT|UNDERFLOW))
+				fprintf(out, "X ");
+			else
+				err++;
+			fprintf(out, "%s:%d: bad fp exception: %s %s(%La,%La)=%La,%lld, want %s",
+				p->file, p->line, rstr(p->r), f->name, p->x, p->x2, p->y, p->i, estr(p->e));
+			fprintf(out, " got %s\n", estr(e));
+		}
+		/* only the sign and the low 3 bits of the quotient are specified */
+		d = ulperrl(y, p->y, p->dy);
+		ustat_add(st, p->r, p->x, d);
+		if (!checkcr(y, p->y, p->r) ||
+		    (!isnan(p->y) && (yi & 7) != (p->i & 7)) ||
+		    (!isnan(p->y) && (yi < 0) != (p->i < 0))) {
+			fprintf(out, "%s:%d: %s %s(%La,%La) want %La,%lld got %La,%lld ulperr %.3f = %a + %a\n",
+				p->file, p->line, rstr(p->r), f->name, p->x, p->x2, p->y, p->i, y, yi, d, d-p->dy, p->dy);
+			err++;
+		}
+	}
+	return err + it.err;
+}
+
+/* wrappers that give every function the call signature of its type */
+#define WI(n,T) static long long w_##n(T x) { return n(x); }
+#define WXI(n,T) static T w_##n(T x, long long i) { return n(x, i); }
+#define WIX(n,T) static T w_##n(T x, long long i) { return n(i, x); }
+#define WXP(n,T) static T w_##n(T x, long long *i) { int k; T y = n(x, &k); *i = k; return y; }
+#define WSG(n,T) static T w_##n(T x, long long *i) { T y = n(x); *i = signgam; return y; }
+#define WMODF(n,T) static void w_##n(T x, T *y, T *y2) { *y = n(x, y2); }
+#define WREMQUO(n,T) static T w_##n(T x, T x2, long long *i) { int k; T y = n(x, x2, &k); *i = k; return y; }
+#define WTOWARD(n,T) static long double w_##n(long double x, long double x2) { return n((T)x, x2); }
+WI(ilogb, double) WI(ilogbf, float) WI(ilogbl, long double)
+WI(lrint, double) WI(lrintf, float) WI(lrintl, long double)
+WI(lround, double) WI(lroundf, float) WI(lroundl, long double)
+WXI(ldexp, double) WXI(ldexpf, float) WXI(ldexpl, long double)
+WXI(scalbn, double) WXI(scalbnf, float) WXI(scalbnl, long double)
+WXI(scalbln, double) WXI(scalblnf, float) WXI(scalblnl, long double)
+WIX(jn, double) WIX(jnf, float)
+WIX(yn, double) WIX(ynf, float)
+WXP(frexp, double) WXP(frexpf, float) WXP(frexpl, long double)
+WXP(lgamma_r, double) WXP(lgammaf_r, float) WXP(lgammal_r, long double)
+WSG(lgamma, double) WSG(lgammaf, float) WSG(lgammal, long double)
+WMODF(modf, double) WMODF(modff, float) WMODF(modfl, long double)
+WREMQUO(remquo, double) WREMQUO(remquof, float) WREMQUO(remquol, long double)
+WTOWARD(nexttoward, double) WTOWARD(nexttowardf, float)
+
+#define V(...) {__VA_ARGS__, 0}
+/* long double functions use the double vectors if long double is double */
+#if LDBL_MANT_DIG == 53
+#define LV(d,l) V d
+#elif LDBL_MANT_DIG == 64
+#define LV(d,l) V l
+#else
+#define LV(d,l) {0}
+#endif
+#define F(n,t,fl,x,v) {#n, #t, (void (*)(void))n, (void (*)(void))n, fl, x, v},
+#define W(n,t,fl,x,v) {#n, #t, (void (*)(void))w_##n, (void (*)(void))n, fl, x, v},
+static const struct fun fun[] = {
+	F(acos, d_d, 0, 0, V("crlibm/acos.h", "ucb/acos.h", "sanity/acos.h", "special/acos.h"))
+	F(acosf, f_f, 0, 0, V("ucb/acosf.h", "sanity/acosf.h", "special/acosf.h"))
+	F(acosh, d_d, 0, 2, V("sanity/acosh.h", "special/acosh.h"))
+	F(acoshf, f_f, 0, 0, V("sanity/acoshf.h", "special/acoshf.h"))
+	F(acoshl, l_l, 0, 0, LV(("sanity/acosh.h", "special/acosh.h"), ("sanity/acoshl.h", "special/acoshl.h")))
+	F(acosl, l_l, 0, 0, LV(("crlibm/acos.h", "ucb/acos.h", "sanity/acos.h", "special/acos.h"), ("sanity/acosl.h", "special/acosl.h")))
+	F(asin, d_d, 0, 0, V("crlibm/asin.h", "ucb/asin.h", "sanity/asin.h", "special/asin.h"))
+	F(asinf, f_f, 0, 0, V("ucb/asinf.h", "sanity/asinf.h", "special/asinf.h"))
+	F(asinh, d_d, 0, 2, V("sanity/asinh.h", "special/asinh.h"))
+	F(asinhf, f_f, 0, 0, V("sanity/asinhf.h", "special/asinhf.h"))
+	F(asinhl, l_l, 0, 0, LV(("sanity/asinh.h", "special/asinh.h"), ("sanity/asinhl.h", "special/asinhl.h")))
+	F(asinl, l_l, 0, 0, LV(("crlibm/asin.h", "ucb/asin.h", "sanity/asin.h", "special/asin.h"), ("sanity/asinl.h", "special/asinl.h")))
+	F(atan, d_d, 0, 0, V("crlibm/atan.h", "ucb/atan.h", "sanity/atan.h", "special/atan.h"))
+	F(atan2, dd_d, 0, 0, V("ucb/atan2.h", "sanity/atan2.h", "special/atan2.h"))
+	F(atan2f, ff_f, 0, 0, V("ucb/atan2f.h", "sanity/atan2f.h", "special/atan2f.h"))
+	F(atan2l, ll_l, 0, 0, LV(("ucb/atan2.h", "sanity/atan2.h", "special/atan2.h"), ("sanity/atan2l.h", "special/atan2l.h")))
+	F(atanf, f_f, 0, 0, V("ucb/atanf.h", "sanity/atanf.h", "special/atanf.h"))
+	F(atanh, d_d, 0, 0, V("sanity/atanh.h", "special/atanh.h"))
+	F(atanhf, f_f, 0, 0, V("sanity/atanhf.h", "special/atanhf.h"))
+	F(atanhl, l_l, 0, 0, LV(("sanity/atanh.h", "special/atanh.h"), ("sanity/atanhl.h", "special/atanhl.h")))
+	F(atanl, l_l, 0, 0, LV(("crlibm/atan.h", "ucb/atan.h", "sanity/atan.h", "special/atan.h"), ("sanity/atanl.h", "special/atanl.h")))
+	F(cbrt, d_d, 0, 0, V("sanity/cbrt.h", "special/cbrt.h"))
+	F(cbrtf, f_f, 0, 0, V("sanity/cbrtf.h", "special/cbrtf.h"))
+	F(cbrtl, l_l, 0, 0, LV(("sanity/cbrt.h", "special/cbrt.h"), ("sanity/cbrtl.h", "special/cbrtl.h")))
+	F(ceil, d_d, EXCALL|ORINEXACT|CR, 0, V("ucb/ceil.h", "sanity/ceil.h", "special/ceil.h"))
+	F(ceilf, f_f, EXCALL|ORINEXACT|CR, 0, V("ucb/ceilf.h", "sanity/ceilf.h", "special/ceilf.h"))
+	F(ceill, l_l, EXCALL|ORINEXACT|CR, 0, LV(("ucb/ceil.h", "sanity/ceil.h", "special/ceil.h"), ("sanity/ceill.h", "special/ceill.h")))
+	F(copysign, dd_d, EXCALL|CR, 0, V("sanity/copysign.h", "special/copysign.h"))
+	F(copysignf, ff_f, EXCALL|CR, 0, V("sanity/copysignf.h", "special/copysignf.h"))
+	F(copysignl, ll_l, EXCALL|CR, 0, LV(("sanity/copysign.h", "special/copysign.h"), ("sanity/copysignl.h", "special/copysignl.h")))
+	F(cos, d_d, XNOTRN, 0, V("crlibm/cos.h", "ucb/cos.h", "sanity/cos.h", "special/cos.h"))
+	F(cosf, f_f, 0, 0, V("ucb/cosf.h", "sanity/cosf.h", "special/cosf.h"))
+	F(cosh, d_d, 0, 0, V("crlibm/cosh.h", "ucb/cosh.h", "sanity/cosh.h", "special/cosh.h"))
+	F(coshf, f_f, 0, 0, V("ucb/coshf.h", "sanity/coshf.h", "special/coshf.h"))
+	F(coshl, l_l, 0, 0, LV(("crlibm/cosh.h", "ucb/cosh.h", "sanity/cosh.h", "special/cosh.h"), ("sanity/coshl.h", "special/coshl.h")))
+	F(cosl, l_l, 0, 0, LV(("crlibm/cos.h", "ucb/cos.h", "sanity/cos.h", "special/cos.h"), ("sanity/cosl.h", "special/cosl.h")))
+	F(drem, dd_d, CR, 0, V("sanity/remainder.h", "special/remainder.h"))
+	F(dremf, ff_f, CR, 0, V("sanity/remainderf.h", "special/remainderf.h"))
+	F(erf, d_d, 0, 4, V("sanity/erf.h", "special/erf.h"))
+	F(erfc, d_d, 0, 4, V("sanity/erfc.h", "special/erfc.h"))
+	F(erfcf, f_f, 0, 0, V("sanity/erfcf.h", "special/erfcf.h"))
+	F(erfcl, l_l, 0, 0, LV(("sanity/erfc.h", "special/erfc.h"), ("sanity/erfcl.h", "special/erfcl.h")))
+	F(erff, f_f, 0, 0, V("sanity/erff.h", "special/erff.h"))
+	F(erfl, l_l, 0, 0, LV(("sanity/erf.h", "special/erf.h"), ("sanity/erfl.h", "special/erfl.h")))
+	F(exp, d_d, 0, 0, V("crlibm/exp.h", "ucb/exp.h", "sanity/exp.h", "special/exp.h"))
+	F(exp10, d_d, 0, 0, V("sanity/exp10.h", "special/exp10.h"))
+	F(exp10f, f_f, 0, 0, V("sanity/exp10f.h", "special/exp10f.h"))
+	F(exp10l, l_l, 0, 0, LV(("sanity/exp10.h", "special/exp10.h"), ("sanity/exp10l.h", "special/exp10l.h")))
+	F(exp2, d_d, XUFLOW, 0, V("sanity/exp2.h", "special/exp2.h"))
+	F(exp2f, f_f, 0, 0, V("sanity/exp2f.h", "special/exp2f.h"))
+	F(exp2l, l_l, 0, 0, LV(("sanity/exp2.h", "special/exp2.h"), ("sanity/exp2l.h", "special/exp2l.h")))
+	F(expf, f_f, 0, 0, V("ucb/expf.h", "sanity/expf.h", "special/expf.h"))
+	F(expl, l_l, 0, 0, LV(("crlibm/exp.h", "ucb/exp.h", "sanity/exp.h", "special/exp.h"), ("sanity/expl.h", "special/expl.h")))
+	F(expm1, d_d, 0, 0, V("crlibm/expm1.h", "sanity/expm1.h", "special/expm1.h"))
+	F(expm1f, f_f, 0, 0, V("sanity/expm1f.h", "special/expm1f.h"))
+	F(expm1l, l_l, 0, 2.5, LV(("crlibm/expm1.h", "sanity/expm1.h", "special/expm1.h"), ("sanity/expm1l.h", "special/expm1l.h")))
+	F(fabs, d_d, EXCALL|CR, 0, V("ucb/fabs.h", "sanity/fabs.h", "special/fabs.h"))
+	F(fabsf, f_f, EXCALL|CR, 0, V("ucb/fabsf.h", "sanity/fabsf.h", "special/fabsf.h"))
+	F(fabsl, l_l, EXCALL|CR, 0, LV(("ucb/fabs.h", "sanity/fabs.h", "special/fabs.h"), ("sanity/fabsl.h", "special/fabsl.h")))
+	F(fdim, dd_d, EXCALL|CR, 0, V("sanity/fdim.h", "special/fdim.h"))
+	F(fdimf, ff_f, EXCALL|CR, 0, V("sanity/fdimf.h", "special/fdimf.h"))
+	F(fdiml, ll_l, EXCALL|CR, 0, LV(("sanity/fdim.h", "special/fdim.h"), ("sanity/fdiml.h", "special/fdiml.h")))
+	F(floor, d_d, EXCALL|ORINEXACT|CR, 0, V("ucb/floor.h", "sanity/floor.h", "special/floor.h"))
+	F(floorf, f_f, EXCALL|ORINEXACT|CR, 0, V("ucb/floorf.h", "sanity/floorf.h", "special/floorf.h"))
+	F(floorl, l_l, EXCALL|ORINEXACT|CR, 0, LV(("ucb/floor.h", "sanity/floor.h", "special/floor.h"), ("sanity/floorl.h", "special/floorl.h")))
+	F(fma, ddd_d, NOINEXACT|CR, 0, V("sanity/fma.h", "special/fma.h"))
+	F(fmaf, fff_f, NOINEXACT|CR, 0, V("sanity/fmaf.h", "special/fmaf.h"))
+	F(fmal, lll_l, NOINEXACT|CR, 0, LV(("sanity/fma.h", "special/fma.h"), ("sanity/fmal.h", "special/fmal.h")))
+	F(fmax, dd_d, EXCALL|CR, 0, V("sanity/fmax.h", "special/fmax.h"))
+	F(fmaxf, ff_f, EXCALL|CR, 0, V("sanity/fmaxf.h", "special/fmaxf.h"))
+	F(fmaxl, ll_l, EXCALL|CR, 0, LV(("sanity/fmax.h", "special/fmax.h"), ("sanity/fmaxl.h", "special/fmaxl.h")))
+	F(fmin, dd_d, EXCALL|CR, 0, V("sanity/fmin.h", "special/fmin.h"))
+	F(fminf, ff_f, EXCALL|CR, 0, V("sanity/fminf.h", "special/fminf.h"))
+	F(fminl, ll_l, EXCALL|CR, 0, LV(("sanity/fmin.h", "special/fmin.h"), ("sanity/fminl.h", "special/fminl.h")))
+	F(fmod, dd_d, CR, 0, V("ucb/fmod.h", "sanity/fmod.h", "special/fmod.h"))
+	F(fmodf, ff_f, CR, 0, V("ucb/fmodf.h", "sanity/fmodf.h", "special/fmodf.h"))
+	F(fmodl, ll_l, CR, 0, LV(("ucb/fmod.h", "sanity/fmod.h", "special/fmod.h"), ("sanity/fmodl.h", "special/fmodl.h")))
+	W(frexp, d_di, EXCALL|CR, 0, V("sanity/frexp.h", "special/frexp.h"))
+	W(frexpf, f_fi, EXCALL|CR, 0, V("sanity/frexpf.h", "special/frexpf.h"))
+	W(frexpl, l_li, EXCALL|CR, 0, LV(("sanity/frexp.h", "special/frexp.h"), ("sanity/frexpl.h", "special/frexpl.h")))
+	F(hypot, dd_d, ULP1, 0, V("ucb/hypot.h", "sanity/hypot.h", "special/hypot.h"))
+	F(hypotf, ff_f, ULP1, 0, V("ucb/hypotf.h", "sanity/hypotf.h", "special/hypotf.h"))
+	F(hypotl, ll_l, ULP1, 0, LV(("ucb/hypot.h", "sanity/hypot.h", "special/hypot.h"), ("sanity/hypotl.h", "special/hypotl.h")))
+	W(ilogb, d_i, ALLI, 0, V("sanity/ilogb.h", "special/ilogb.h"))
+	W(ilogbf, f_i, ALLI, 0, V("sanity/ilogbf.h", "special/ilogbf.h"))
+	W(ilogbl, l_i, ALLI, 0, LV(("sanity/ilogb.h", "special/ilogb.h"), ("sanity/ilogbl.h", "special/ilogbl.h")))
+	F(j0, d_d, 0, 0x1p52, V("sanity/j0.h", "special/j0.h"))
+	F(j0f, f_f, 0, 0x1p23, V("sanity/j0f.h", "special/j0f.h"))
+	F(j1, d_d, 0, 0, V("sanity/j1.h", "special/j1.h"))
+	F(j1f, f_f, 0, 0, V("sanity/j1f.h", "special/j1f.h"))
+	W(jn, di_d, IFIRST, 3, V("sanity/jn.h", "special/jn.h"))
+	W(jnf, fi_f, IFIRST, 3, V("sanity/jnf.h", "special/jnf.h"))
+	W(ldexp, di_d, EXCALL|CR, 0, V("sanity/ldexp.h", "special/ldexp.h"))
+	W(ldexpf, fi_f, EXCALL|CR, 0, V("sanity/ldexpf.h", "special/ldexpf.h"))
+	W(ldexpl, li_l, EXCALL|CR, 0, LV(("sanity/ldexp.h", "special/ldexp.h"), ("sanity/ldexpl.h", "special/ldexpl.h")))
+	W(lgamma, d_di, SIGNGAM, 11, V("sanity/lgamma.h", "special/lgamma.h"))
+	W(lgamma_r, d_di, 0, 11, V("sanity/lgamma_r.h", "special/lgamma_r.h"))
+	W(lgammaf, f_fi, SIGNGAM, 2, V("sanity/lgammaf.h", "special/lgammaf.h"))
+	W(lgammaf_r, f_fi, 0, 2, V("sanity/lgammaf_r.h", "special/lgammaf_r.h"))
+	W(lgammal, l_li, SIGNGAM|RN2, 0, LV(("sanity/lgamma.h", "special/lgamma.h"), ("sanity/lgammal.h", "special/lgammal.h")))
+	W(lgammal_r, l_li, RN2, 0, LV(("sanity/lgamma_r.h", "special/lgamma_r.h"), ("sanity/lgammal_r.h", "special/lgammal_r.h")))
+	F(llrint, d_i, 0, 0, V("sanity/llrint.h", "special/llrint.h"))
+	F(llrintf, f_i, 0, 0, V("sanity/llrintf.h", "special/llrintf.h"))
+	F(llrintl, l_i, 0, 0, LV(("sanity/llrint.h", "special/llrint.h"), ("sanity/llrintl.h", "special/llrintl.h")))
+	F(llround, d_i, ORINEXACT, 0, V("sanity/llround.h", "special/llround.h"))
+	F(llroundf, f_i, ORINEXACT, 0, V("sanity/llroundf.h", "special/llroundf.h"))
+	F(llroundl, l_i, ORINEXACT, 0, LV(("sanity/llround.h", "special/llround.h"), ("sanity/llroundl.h", "special/llroundl.h")))
+	F(log, d_d, 0, 0, V("crlibm/log.h", "ucb/log.h", "sanity/log.h", "special/log.h"))
+	F(log10, d_d, 0, 0, V("crlibm/log10.h", "ucb/log10.h", "sanity/log10.h", "special/log10.h"))
+	F(log10f, f_f, 0, 0, V("ucb/log10f.h", "sanity/log10f.h", "special/log10f.h"))
+	F(log10l, l_l, 0, 0, LV(("crlibm/log10.h", "ucb/log10.h", "sanity/log10.h", "special/log10.h"), ("sanity/log10l.h", "special/log10l.h")))
+	F(log1p, d_d, 0, 0, V("crlibm/log1p.h", "sanity/log1p.h", "special/log1p.h"))
+	F(log1pf, f_f, 0, 0, V("sanity/log1pf.h", "special/log1pf.h"))
+	F(log1pl, l_l, 0, 0, LV(("crlibm/log1p.h", "sanity/log1p.h", "special/log1p.h"), ("sanity/log1pl.h", "special/log1pl.h")))
+	F(log2, d_d, 0, 0, V("crlibm/log2.h", "sanity/log2.h", "special/log2.h"))
+	F(log2f, f_f, 0, 0, V("sanity/log2f.h", "special/log2f.h"))
+	F(log2l, l_l, 0, 0, LV(("crlibm/log2.h", "sanity/log2.h", "special/log2.h"), ("sanity/log2l.h", "special/log2l.h")))
+	F(logb, d_d, EXCALL|CR, 0, V("sanity/logb.h", "special/logb.h"))
+	F(logbf, f_f, EXCALL|CR, 0, V("sanity/logbf.h", "special/logbf.h"))
+	F(logbl, l_l, EXCALL|CR, 0, LV(("sanity/logb.h", "special/logb.h"), ("sanity/logbl.h", "special/logbl.h")))
+	F(logf, f_f, 0, 0, V("ucb/logf.h", "sanity/logf.h", "special/logf.h"))
+	F(logl, l_l, 0, 0, LV(("crlibm/log.h", "ucb/log.h", "sanity/log.h", "special/log.h"), ("sanity/logl.h", "special/logl.h")))
+	W(lrint, d_i, 0, 0, V("sanity/lrint.h", "special/lrint.h"))
+	W(lrintf, f_i, 0, 0, V("sanity/lrintf.h", "special/lrintf.h"))
+	W(lrintl, l_i, 0, 0, LV(("sanity/lrint.h", "special/lrint.h"), ("sanity/lrintl.h", "special/lrintl.h")))
+	W(lround, d_i, ORINEXACT, 0, V("sanity/lround.h", "special/lround.h"))
+	W(lroundf, f_i, ORINEXACT, 0, V("sanity/lroundf.h", "special/lroundf.h"))
+	W(lroundl, l_i, ORINEXACT, 0, LV(("sanity/lround.h", "special/lround.h"), ("sanity/lroundl.h", "special/lroundl.h")))
+	W(modf, d_dd, NOINEXACT|CR, 0, V("sanity/modf.h", "special/modf.h"))
+	W(modff, f_ff, NOINEXACT|CR, 0, V("sanity/modff.h", "special/modff.h"))
+	W(modfl, l_ll, NOINEXACT|CR, 0, LV(("sanity/modf.h", "special/modf.h"), ("sanity/modfl.h", "special/modfl.h")))
+	F(nearbyint, d_d, EXCALL|CR, 0, V("sanity/nearbyint.h", "special/nearbyint.h"))
+	F(nearbyintf, f_f, EXCALL|CR, 0, V("sanity/nearbyintf.h", "special/nearbyintf.h"))
+	F(nearbyintl, l_l, EXCALL|CR, 0, LV(("sanity/nearbyint.h", "special/nearbyint.h"), ("sanity/nearbyintl.h", "special/nearbyintl.h")))
+	F(nextafter, dd_d, EXCALL|CR, 0, V("sanity/nextafter.h", "special/nextafter.h"))
+	F(nextafterf, ff_f, EXCALL|CR, 0, V("sanity/nextafterf.h", "special/nextafterf.h"))
+	F(nextafterl, ll_l, EXCALL|CR, 0, LV(("sanity/nextafter.h", "special/nextafter.h"), ("sanity/nextafterl.h", "special/nextafterl.h")))
+	W(nexttoward, ll_l, EXCALL|CR|RESD, 0, LV(("sanity/nexttoward.h", "special/nexttoward.h"), ("sanity/nexttoward.h", "special/nexttoward.h")))
+	W(nexttowardf, ll_l, EXCALL|CR|RESF, 0, LV(("sanity/nexttowardf.h", "special/nexttowardf.h"), ("sanity/nexttowardf.h", "special/nexttowardf.h")))
+	F(nexttowardl, ll_l, EXCALL|CR, 0, LV(("sanity/nexttoward.h", "special/nexttoward.h"), ("sanity/nexttowardl.h", "special/nexttowardl.h")))
+	F(pow, dd_d, XUFLOW, 0, V("crlibm/pow.h", "ucb/pow.h", "sanity/pow.h", "special/pow.h"))
+	F(pow10, d_d, 0, 0, V("sanity/pow10.h", "special/exp10.h"))
+	F(pow10f, f_f, 0, 0, V("sanity/pow10f.h", "special/exp10f.h"))
+	F(pow10l, l_l, 0, 0, LV(("sanity/pow10.h", "special/exp10.h"), ("sanity/pow10l.h", "special/exp10l.h")))
+	F(powf, ff_f, XUFLOW, 0, V("ucb/powf.h", "sanity/powf.h", "special/powf.h"))
+	F(powl, ll_l, 0, 0, LV(("crlibm/pow.h", "ucb/pow.h", "sanity/pow.h", "special/pow.h"), ("sanity/powl.h", "special/powl.h")))
+	F(remainder, dd_d, CR, 0, V("sanity/remainder.h", "special/remainder.h"))
+	F(remainderf, ff_f, CR, 0, V("sanity/remainderf.h", "special/remainderf.h"))
+	F(remainderl, ll_l, CR, 0, LV(("sanity/remainder.h", "special/remainder.h"), ("sanity/remainderl.h", "special/remainderl.h")))
+	W(remquo, dd_di, CR, 0, V("sanity/remquo.h", "special/remquo.h"))
+	W(remquof, ff_fi, CR, 0, V("sanity/remquof.h", "special/remquof.h"))
+	W(remquol, ll_li, CR, 0, LV(("sanity/remquo.h", "special/remquo.h"), ("sanity/remquol.h", "special/remquol.h")))
+	F(rint, d_d, EXCALL|CR, 0, V("sanity/rint.h", "special/rint.h"))
+	F(rintf, f_f, EXCALL|CR, 0, V("sanity/rintf.h", "special/rintf.h"))
+	F(rintl, l_l, EXCALL|CR, 0, LV(("sanity/rint.h", "special/rint.h"), ("sanity/rintl.h", "special/rintl.h")))
+	F(round, d_d, EXCALL|ORINEXACT|CR, 0, V("sanity/round.h", "special/round.h"))
+	F(roundf, f_f, EXCALL|ORINEXACT|CR, 0, V("sanity/roundf.h", "special/roundf.h"))
+	F(roundl, l_l, EXCALL|ORINEXACT|CR, 0, LV(("sanity/round.h", "special/round.h"), ("sanity/roundl.h", "special/roundl.h")))
+	F(scalb, dd_d, EXCALL|CR, 0, V("sanity/scalb.h", "special/scalb.h"))
+	F(scalbf, ff_f, EXCALL|CR, 0, V("sanity/scalbf.h", "special/scalbf.h"))
+	W(scalbln, di_d, EXCALL|CR, 0, V("sanity/scalbln.h", "special/scalbln.h"))
+	W(scalblnf, fi_f, EXCALL|CR, 0, V("sanity/scalblnf.h", "special/scalblnf.h"))
+	W(scalblnl, li_l, EXCALL|CR, 0, LV(("sanity/scalbln.h", "special/scalbln.h"), ("sanity/scalblnl.h", "special/scalblnl.h")))
+	W(scalbn, di_d, EXCALL|CR, 0, V("sanity/scalbn.h", "special/scalbn.h"))
+	W(scalbnf, fi_f, EXCALL|CR, 0, V("sanity/scalbnf.h", "special/scalbnf.h"))
+	W(scalbnl, li_l, EXCALL|CR, 0, LV(("sanity/scalbn.h", "special/scalbn.h"), ("sanity/scalbnl.h", "special/scalbnl.h")))
+	F(sin, d_d, XNOTRN, 0, V("crlibm/sin.h", "ucb/sin.h", "sanity/sin.h", "special/sin.h"))
+	F(sincos, d_dd, 0, 0, V("sanity/sincos.h", "special/sincos.h"))
+	F(sincosf, f_ff, 0, 0, V("sanity/sincosf.h", "special/sincosf.h"))
+	F(sincosl, l_ll, 0, 0, LV(("sanity/sincos.h", "special/sincos.h"), ("sanity/sincosl.h", "special/sincosl.h")))
+	F(sinf, f_f, 0, 0, V("ucb/sinf.h", "sanity/sinf.h", "special/sinf.h"))
+	F(sinh, d_d, XNOTRN, 2, V("crlibm/sinh.h", "ucb/sinh.h", "sanity/sinh.h", "special/sinh.h"))
+	F(sinhf, f_f, XNOTRN, 0, V("ucb/sinhf.h", "sanity/sinhf.h", "special/sinhf.h"))
+	F(sinhl, l_l, XNOTRN, 5, LV(("crlibm/sinh.h", "ucb/sinh.h", "sanity/sinh.h", "special/sinh.h"), ("sanity/sinhl.h", "special/sinhl.h")))
+	F(sinl, l_l, 0, 0, LV(("crlibm/sin.h", "ucb/sin.h", "sanity/sin.h", "special/sin.h"), ("sanity/sinl.h", "special/sinl.h")))
+	F(sqrt, d_d, EXCALL|CR, 0, V("ucb/sqrt.h", "sanity/sqrt.h", "special/sqrt.h"))
+	F(sqrtf, f_f, EXCALL|CR, 0, V("ucb/sqrtf.h", "sanity/sqrtf.h", "special/sqrtf.h"))
+	F(sqrtl, l_l, EXCALL|CR, 0, LV(("ucb/sqrt.h", "sanity/sqrt.h", "special/sqrt.h"), ("sanity/sqrtl.h", "special/sqrtl.h")))
+	F(tan, d_d, XNOTRN, 0, V("crlibm/tan.h", "ucb/tan.h", "sanity/tan.h", "special/tan.h"))
+	F(tanf, f_f, 0, 0, V("ucb/tanf.h", "sanity/tanf.h", "special/tanf.h"))
+	F(tanh, d_d, 0, 0, V("ucb/tanh.h", "sanity/tanh.h", "special/tanh.h"))
+	F(tanhf, f_f, 0, 0, V("ucb/tanhf.h", "sanity/tanhf.h", "special/tanhf.h"))
+	F(tanhl, l_l, 0, 0, LV(("ucb/tanh.h", "sanity/tanh.h", "special/tanh.h"), ("sanity/tanhl.h", "special/tanhl.h")))
+	F(tanl, l_l, 0, 0, LV(("crlibm/tan.h", "ucb/tan.h", "sanity/tan.h", "special/tan.h"), ("sanity/tanl.h", "special/tanl.h")))
+	F(tgamma, d_d, 0, 5.5, V("sanity/tgamma.h", "special/tgamma.h"))
+	F(tgammaf, f_f, 0, 0, V("sanity/tgammaf.h", "special/tgammaf.h"))
+	F(tgammal, l_l, RN2, 0, LV(("sanity/tgamma.h", "special/tgamma.h"), ("sanity/tgammal.h", "special/tgammal.h")))
+	F(trunc, d_d, EXCALL|ORINEXACT|CR, 0, V("sanity/trunc.h", "special/trunc.h"))
+	F(truncf, f_f, EXCALL|ORINEXACT|CR, 0, V("sanity/truncf.h", "special/truncf.h"))
+	F(truncl, l_l, EXCALL|ORINEXACT|CR, 0, LV(("sanity/trunc.h", "special/trunc.h"), ("sanity/truncl.h", "special/truncl.h")))
+	F(y0, d_d, YNEG, 0x1p52, V("sanity/y0.h", "special/y0.h"))
+	F(y0f, f_f, YNEG, 0x1p23, V("sanity/y0f.h", "special/y0f.h"))
+	F(y1, d_d, YNEG, 0, V("sanity/y1.h", "special/y1.h"))
+	F(y1f, f_f, YNEG, 0, V("sanity/y1f.h", "special/y1f.h"))
+	W(yn, di_d, IFIRST|YNEG, 0, V("sanity/yn.h", "special/yn.h"))
+	W(ynf, fi_f, IFIRST|YNEG, 2.5, V("sanity/ynf.h", "special/ynf.h"))
+};
+#undef F
+#undef W
+
+
+/*
+benchmark (-B): each function is timed on the first arguments of its RN
+vectors and on uniform random first arguments in each bounded input
+range of struct ustat (the other arguments are taken from the vectors),
+in a throughput loop of independent calls and in a latency loop where
+every argument depends on the previous result, both measured with
+t_bench (see bench.c), the median and MAD are reported in ns/call. the
+dependency goes through memory, so latency includes a few cycles of
+store forwarding for every function alike.
+*/
+enum {BN = 4096};
+
+struct bin {
+	union {float f; double d; long double l;} x[3];
+	long long i;
+};
+
+/* 0, but the compiler cannot know that so the dependency is kept */
+static uint64_t bzeromask;
+static volatile uint64_t vzeromask;
+
+#define L1(m) b->x[0].m = p->x;
+#define L2(m) L1(m) b->x[1].m = p->x2;
+#define L3(m) L2(m) b->x[2].m = p->x3;
+#define LI(m) L1(m) b->i = p->i;
+#define BENCH(t, T, m, R, L, CALL) \
+static int load_##t(const void *v, struct bin *b) \
+{ \
+	const struct t *p = v; \
+	if (p->r != RN) \
+		return 0; \
+	L(m) \
+	return 1; \
+} \
+static void tput_##t(const struct fun *f, const struct bin *b, size_t n) \
+{ \
+	T x, x2, x3, y2; \
+	long long i, yi; \
+	size_t k; \
+	for (k = 0; k < n; k++) { \
+		x = b[k].x[0].m; \
+		x2 = b[k].x[1].m; \
+		x3 = b[k].x[2].m; \
+		i = b[k].i; \
+		{ R y; CALL; (void)y; } \
+	} \
+	(void)x2; (void)x3; (void)i; (void)y2; (void)yi; \
+} \
+static void lat_##t(const struct fun *f, const struct bin *b, size_t n) \
+{ \
+	union {uint64_t u; R v;} ry = {0}; \
+	union {uint64_t u; T v;} rx; \
+	T x, x2, x3, y2; \
+	long long i, yi; \
+	size_t k; \
+	for (k = 0; k < n; k++) { \
+		rx.u = 0; \
+		rx.v = b[k].x[0].m; \
+		rx.u |= ry.u & bzeromask; \
+		x = rx.v; \
+		x2 = b[k].x[1].m; \
+		x3 = b[k].x[2].m; \
+		i = b[k].i; \
+		{ R y; CALL; ry.v = y; } \
+	} \
+	(void)x2; (void)x3; (void)i; (void)y2; (void)yi; \
+}
+BENCH(d_d, double, d, double, L1, y = ((double (*)(double))f->f)(x))
+BENCH(f_f, float, f, float, L1, y = ((float (*)(float))f->f)(x))
+BENCH(l_l, long double, l, long double, L1, y = ((long double (*)(long double))f->f)(x))
+BENCH(dd_d, double, d, double, L2, y = ((double (*)(double, double))f->f)(x, x2))
+BENCH(ff_f, float, f, float, L2, y = ((float (*)(float, float))f->f)(x, x2))
+BENCH(ll_l, long double, l, long double, L2, y = ((long double (*)(long double, long double))f->f)(x, x2))
+BENCH(ddd_d, double, d, double, L3, y = ((double (*)(double, double, double))f->f)(x, x2, x3))
+BENCH(fff_f, float, f, float, L3, y = ((float (*)(float, float, float))f->f)(x, x2, x3))
+BENCH(lll_l, long double, l, long double, L3, y = ((long double (*)(long double, long double, long double))f->f)(x, x2, x3))
+BENCH(di_d, double, d, double, LI, y = ((double (*)(double, long long))f->f)(x, i))
+BENCH(fi_f, float, f, float, LI, y = ((float (*)(float, long long))f->f)(x, i))
+BENCH(li_l, long double, l, long double, LI, y = ((long double (*)(long double, long long))f->f)(x, i))
+BENCH(d_di, double, d, double, L1, y = ((double (*)(double, long long *))f->f)(x, &yi))
+BENCH(f_fi, float, f, float, L1, y = ((float (*)(float, long long *))f->f)(x, &yi))
+BENCH(l_li, long double, l, long double, L1, y = ((long double (*)(long double, long long *))f->f)(x, &yi))
+BENCH(d_i, double, d, long long, L1, y = ((long long (*)(double))f->f)(x))
+BENCH(f_i, float, f, long long, L1, y = ((long long (*)(float))f->f)(x))
+BENCH(l_i, long double, l, long long, L1, y = ((long long (*)(long double))f->f)(x))
+BENCH(d_dd, double, d, double, L1, ((void (*)(double, double *, double *))f->f)(x, &y, &y2))
+BENCH(f_ff, float, f, float, L1, ((void (*)(float, float *, float *))f->f)(x, &y, &y2))
+BENCH(l_ll, long double, l, long double, L1, ((void (*)(long double, long double *, long double *))f->f)(x, &y, &y2))
+BENCH(dd_di, double, d, double, L2, y = ((double (*)(double, double, long long *))f->f)(x, x2, &yi))
+BENCH(ff_fi, float, f, float, L2, y = ((float (*)(float, float, long long *))f->f)(x, x2, &yi))
+BENCH(ll_li, long double, l, long double, L2, y = ((long double (*)(long double, long double, long long *))f->f)(x, x2, &yi))
+#undef BENCH
+#undef L1
+#undef L2
+#undef L3
+#undef LI
+
+static struct {
+	char *type;
+	int (*run)(const struct fun *, struct ustat *, FILE *);
+	size_t size;
+	int (*load)(const void *, struct bin *);
+	void (*tput)(const struct fun *, const struct bin *, size_t);
+	void (*lat)(const struct fun *, const struct bin *, size_t);
+} sig[] = {
+#define S(t) {#t, run_##t, sizeof(struct t), load_##t, tput_##t, lat_##t},
+	S(d_d) S(f_f) S(l_l)
+	S(dd_d) S(ff_f) S(ll_l)
+	S(ddd_d) S(fff_f) S(lll_l)
+	S(di_d) S(fi_f) S(li_l)
+	S(d_di) S(f_fi) S(l_li)
+	S(d_i) S(f_i) S(l_i)
+	S(d_dd) S(f_ff) S(l_ll)
+	S(dd_di) S(ff_fi) S(ll_li)
+#undef S
+};
+
+#define NFUN (sizeof fun/sizeof *fun)
+#define NSIG (sizeof sig/sizeof *sig)
+
+static struct {
+	int run;
+	int err;
+	char *out;
+	size_t len;
+	struct ustat *st;
+} res[NFUN];
+
+static FILE *hfile;
+static int benchmode;
+
+static size_t next;
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t sglock = PTHREAD_MUTEX_INITIALIZER;
+
+static size_t findsig(const char *type)
+{
+	size_t j;
+
+	for (j = 0; j < NSIG; j++)
+		if (strcmp(sig[j].type, type) == 0)
+			break;
+	return j;
+}
+
+/* a kernel on its inputs for t_bench, one iteration is one call */
+struct barg {
+	void (*k)(const struct fun *, const struct bin *, size_t);
+	const struct fun *f;
+	const struct bin *b;
+	size_t n;
+};
+
+static void brun(void *p, long iter)
+{
+	const struct barg *a = p;
+	size_t m;
+
+	for (; iter > 0; iter -= m) {
+		m = (size_t)iter < a->n ? (size_t)iter : a->n;
+		a->k(a->f, a->b, m);
+	}
+}
+
+/* uniform random first argument in [2^lo,2^hi) with the sign it replaces */
+static int brand(struct bin *b, char prec, int lo, int hi)
+{
+	long double max = prec == 'f' ? FLT_MAX : prec == 'd' ? DBL_MAX : LDBL_MAX;
+	long double a = ldexpl(1, lo), c = ldexpl(1, hi), x;
+	int neg;
+
+	if (a > max)
+		return 0;
+	if (c > max)
+		c = max;
+	x = a + (c - a) * (t_randn((uint64_t)1 << 53) * 0x1p-53L);
+	if (prec == 'f') {
+		neg = signbit(b->x[0].f);
+		b->x[0].f = neg ? -x : x;
+	} else if (prec == 'd') {
+		neg = signbit(b->x[0].d);
+		b->x[0].d = neg ? -x : x;
+	} else {
+		neg = signbit(b->x[0].l);
+		b->x[0].l = neg ? -x : x;
+	}
+	return 1;
+}
+
+static void brow(const struct fun *f, size_t j, const char *name, const struct bin *b, size_t n)
+{
+	struct barg a = {sig[j].tput, f, b, n};
+	struct t_bench tput, lat;
+	char id[64];
+	int r;
+
+	snprintf(id, sizeof id, "%s/%s/tput", f->name, name);
+	r = t_bench(&tput, id, brun, &a);
+	a.k = sig[j].lat;
+	snprintf(id, sizeof id, "%s/%s/lat", f->name, name);
+	if (r || t_bench(&lat, id, brun, &a)) {
+		printf("%-12s %-16s: deadline reached\n", f->name, name);
+		return;
+	}
+	printf("%-12s %-16s %6zu %9.2f %5.1f%% %9.2f %5.1f%%\n", f->name, name, n,
+		tput.med*1e9, tput.med ? 100*tput.mad/tput.med : 0,
+		lat.med*1e9, lat.med ? 100*lat.mad/lat.med : 0);
+	fflush(stdout);
+}
+
+static int bench(size_t i)
+{
+	const struct fun *f = fun + i;
+	struct bin *v = 0, *b;
+	struct miter it;
+	void *p;
+	size_t j, k, n = 0, cap = 0;
+	char name[32];
+	int x, lo, hi;
+
+	j = findsig(f->type);
+	if (j == NSIG || !f->sym) {
+		printf("%s: not available\n", f->name);
+		return 1;
+	}
+	minit(&it, f->type, 0, 0, sig[j].size, __FILE__, (char **)f->vec);
+	while ((p = mnext(&it))) {
+		if (n == cap) {
+			cap = cap ? 2*cap : 256;
+			if (!(b = realloc(v, cap * sizeof *v))) {
+				printf("%s: no memory for inputs\n", f->name);
+				free(v);
+				return 1;
+			}
+			v = b;
+		}
+		memset(v + n, 0, sizeof *v);
+		n += sig[j].load(p, v + n);
+	}
+	if (n == 0) {
+		printf("%s: no RN vectors to take inputs from\n", f->name);
+		free(v);
+		return 1;
+	}
+	if (!(b = malloc(BN * sizeof *b))) {
+		printf("%s: no memory for inputs\n", f->name);
+		free(v);
+		return 1;
+	}
+	fesetround(RN);
+	brow(f, j, "vectors", v, n);
+	for (x = 0; x < USTAT_NX; x++) {
+		if (!ustat_xbound(x, &lo, &hi))
+			continue;
+		for (k = 0; k < BN; k++) {
+			b[k] = v[k % n];
+			if (!brand(b + k, f->type[0], lo, hi))
+				break;
+		}
+		if (k < BN)
+			continue;
+		ustat_xname(name, sizeof name, x);
+		brow(f, j, name, b, BN);
+	}
+	free(b);
+	free(v);
+	return 0;
+}
+
+static void runfun(size_t i)
+{
+	const struct fun *f = fun + i;
+	FILE *out;
+	size_t j;
+
+	out = open_memstream(&res[i].out, &res[i].len);
+	if (!out) {
+		printf("%s: open_memstream failed\n", f->name);
+		res[i].err = 1;
+		return;
+	}
+	j = findsig(f->type);
+	if (j == NSIG) {
+		fprintf(out, "%s: unknown type %s\n", f->name, f->type);
+		res[i].err = 1;
+	} else if (!f->sym) {
+		fprintf(out, "%s: not available\n", f->name);
+		res[i].err = 1;
+	} else {
+		if (f->flags & SIGNGAM)
+			pthread_mutex_lock(&sglock);
+		if (hfile && !(res[i].st = calloc(1, sizeof *res[i].st)))
+			fprintf(out, "%s: no memory for statistics\n", f->name);
+		res[i].err = sig[j].run(f, res[i].st, out);
+		if (f->flags & SIGNGAM)
+			pthread_mutex_unlock(&sglock);
+	}
+	fesetround(RN);
+	fclose(out);
+}
+
+static void *worker(void *arg)
+{
+	size_t i;
+
+	for (;;) {
+		pthread_mutex_lock(&lock);
+		while (next < NFUN && !res[next].run)
+			next++;
+		i = next++;
+		pthread_mutex_unlock(&lock);
+		if (i >= NFUN)
+			return 0;
+		runfun(i);
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	pthread_t td[64];
+	size_t i;
+	long n;
+	int j, opt, r, err = 0;
+	char *e;
+
+	n = sysconf(_SC_NPROCESSORS_ONLN);
+	while ((opt = getopt(argc, argv, "j:H:SB")) != -1) {
+		if (opt == 'S')
+			strict = 1;
+		else if (opt == 'B')
+			benchmode = 1;
+		else if (opt == 'H' && !hfile) {
+			hfile = strcmp(optarg, "-") == 0 ? stdout : fopen(optarg, "w");
+			if (!hfile) {
+				fprintf(stderr, "%s: %s\n", optarg, strerror(errno));
+				return 2;
+			}
+		} else if (opt != 'j' || (n = strtol(optarg, &e, 0), *e)) {
+			fprintf(stderr, "usage: %s [-j nthreads] [-H csvfile] [-S] [-B] [func..]\n", argv[0]);
+			return 2;
+		}
+	}
+	if (n < 1)
+		n = 1;
+	if (n > sizeof td/sizeof *td)
+		n = sizeof td/sizeof *td;
+
+	for (i = 0; i < NFUN; i++)
+		res[i].run = optind == argc;
+	for (j = optind; j < argc; j++) {
+		for (i = 0; i < NFUN; i++)
+			if (strcmp(argv[j], fun[i].name) == 0)
+				break;
+		if (i == NFUN) {
+			printf("%s: unknown function\n", argv[j]);
+			err = 1;
+			continue;
+		}
+		res[i].run = 1;
+	}
+
+	if (benchmode) {
+		/* one function at a time, parallel threads would disturb the timing */
+		bzeromask = vzeromask;
+		printf("%-12s %-16s %6s %9s %6s %9s %6s\n", "func", "inputs", "n", "tput(ns)", "mad", "lat(ns)", "mad");
+		for (i = 0; i < NFUN; i++)
+			if (res[i].run && bench(i))
+				err = 1;
+		return err;
+	}
+
+	for (j = 0; j < n; j++)
+		if ((r = pthread_create(td + j, 0, worker, 0))) {
+			printf("pthread_create failed: %s\n", strerror(r));
+			break;
+		}
+	/* run the rest in the main thread if no thread could be created */
+	if (j == 0)
+		worker(0);
+	while (j--)
+		pthread_join(td[j], 0);
+
+	for (i = 0; i < NFUN; i++) {
+		if (res[i].out)
+			fwrite(res[i].out, 1, res[i].len, stdout);
+		free(res[i].out);
+		if (res[i].err) {
+			printf("FAIL %s\n", fun[i].name);
+			err = 1;
+		}
+	}
+	if (hfile) {
+		ustat_csvhead(hfile);
+		for (i = 0; i < NFUN; i++)
+			if (res[i].st) {
+				ustat_csv(hfile, fun[i].name, res[i].st);
+				free(res[i].st);
+			}
+		if (fflush(hfile) || (hfile != stdout && fclose(hfile))) {
+			printf("writing statistics failed: %s\n", strerror(errno));
+			err = 1;
+		}
+	}
+	return err;
+}
@@ -0,0 +1,457 @@
+/*
+./exhaust checks single argument float functions on all 2^32 inputs
+
+usage: ./exhaust [-j nthreads] [-r RN,RZ,RD,RU] [-a lo] [-b hi] [-k worst] [-u ulpthres] [-C cachedir] func.. | all
+
+the input range [lo,hi) is given as float bit patterns (default: all),
+it is split into chunks that the threads pick up one by one.
+
+the fast reference is the long double (or double for the bessel
+functions) libm function evaluated in RN, once per input, then it is
+rounded to float in each rounding mode. it is not correctly rounded, so
+every result that differs from it and every input where it is too close
+to a float rounding boundary (counted as hard) is evaluated again with
+mpfr (as in gen) and that decides. the results where the fast reference
+was wrong are counted as badref, the worst inputs are evaluated again
+with mpfr before they are printed. with -C dir the mpfr results are
+looked up in and added to dir/func.cache, the cache of gen -C (see
+mcache.c), so a rerun only evaluates the new inputs with mpfr.
+
+for each function and rounding mode the max ulp error, the number of
+not correctly rounded results (mismatch), the number of results with
+ulp error above ulpthres (fail, default is 1.5 in RN and 3 otherwise,
+as in mtest.h) and the worst inputs are printed, the worst input lines
+are valid gen input so they can be turned into test vectors:
+
+./exhaust -k 4 sinf |grep -v '^#' |./gen sinf
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "gen.h"
+
+#define CHUNK (1<<16)
+#define MAXK 64
+
+static long double j0r(long double x) { return j0(x); }
+static long double j1r(long double x) { return j1(x); }
+static long double y0r(long double x) { return y0(x); }
+static long double y1r(long double x) { return y1(x); }
+
+static struct fun {
+	char *name;
+	float (*f)(float);
+	long double (*ref)(long double);
+	int prec;
+	int (*mp)(struct t *);
+} fun[] = {
+#define T(f,ref,prec) {#f, f, ref, prec, mp##f},
+#define L LDBL_MANT_DIG
+T(acosf, acosl, L)
+T(acoshf, acoshl, L)
+T(asinf, asinl, L)
+T(asinhf, asinhl, L)
+T(atanf, atanl, L)
+T(atanhf, atanhl, L)
+T(cbrtf, cbrtl, L)
+T(ceilf, ceill, L)
+T(cosf, cosl, L)
+T(coshf, coshl, L)
+T(erff, erfl, L)
+T(erfcf, erfcl, L)
+T(expf, expl, L)
+T(exp2f, exp2l, L)
+T(exp10f, exp10l, L)
+T(expm1f, expm1l, L)
+T(fabsf, fabsl, L)
+T(floorf, floorl, L)
+T(logf, logl, L)
+T(log10f, log10l, L)
+T(log1pf, log1pl, L)
+T(log2f, log2l, L)
+T(logbf, logbl, L)
+T(nearbyintf, nearbyintl, L)
+T(rintf, rintl, L)
+T(roundf, roundl, L)
+T(sinf, sinl, L)
+T(sinhf, sinhl, L)
+T(sqrtf, sqrtl, L)
+T(tanf, tanl, L)
+T(tanhf, tanhl, L)
+T(tgammaf, tgammal, L)
+T(truncf, truncl, L)
+T(j0f, j0r, DBL_MANT_DIG)
+T(j1f, j1r, DBL_MANT_DIG)
+T(y0f, y0r, DBL_MANT_DIG)
+T(y1f, y1r, DBL_MANT_DIG)
+#undef L
+#undef T
+};
+
+static int rmode[] = {RN, RZ, RD, RU};
+enum {NR = sizeof rmode/sizeof *rmode};
+
+struct worst {
+	float err;
+	uint32_t x;
+	float got;
+	float want;
+};
+
+struct stat {
+	float maxerr;
+	uint64_t mismatch;
+	uint64_t fail;
+	uint64_t hard;
+	uint64_t badref;
+	int nworst;
+	struct worst worst[MAXK];
+};
+
+static int rused[NR];
+static int nworst = 8;
+static double ulpthres = -1;
+static uint64_t lo = 0, hi = 1ULL<<32;
+
+static struct fun *curf;
+static uint64_t next;
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t mplock = PTHREAD_MUTEX_INITIALIZER;
+static int mpsafe;
+static char *cachedir;
+static struct stat total[NR];
+
+static float asfloat(uint32_t i)
+{
+	union {uint32_t i; float f;} u = {i};
+	return u.f;
+}
+
+/* ulp error of y compared to the reference, ulps are taken at yr */
+static float err(float y, long double ref, float yr)
+{
+	if (isnan(y) || isnan(ref))
+		return isnan(y) && isnan(ref) ? 0 : inf;
+	if (y == yr && signbit(y) == signbit(yr) && isinf(y))
+		return 0;
+	if (isinf(y))
+		y = copysignf(0x1p127f, y) * 2;
+	return fabsl(scalbnl(y - ref, -eulpf(yr)));
+}
+
+static void add(struct stat *s, uint32_t x, float e, float got, float want)
+{
+	int i;
+
+	if (e > s->maxerr)
+		s->maxerr = e;
+	if (s->nworst == nworst && e <= s->worst[nworst-1].err)
+		return;
+	if (s->nworst < nworst)
+		s->nworst++;
+	for (i = s->nworst-1; i > 0 && s->worst[i-1].err < e; i--)
+		s->worst[i] = s->worst[i-1];
+	s->worst[i] = (struct worst){e, x, got, want};
+}
+
+static void merge(struct stat *d, struct stat *s)
+{
+	int i;
+
+	d->mismatch += s->mismatch;
+	d->fail += s->fail;
+	d->hard += s->hard;
+	d->badref += s->badref;
+	for (i = 0; i < s->nworst; i++)
+		add(d, s->worst[i].x, s->worst[i].err, s->worst[i].got, s->worst[i].want);
+	if (s->maxerr > d->maxerr)
+		d->maxerr = s->maxerr;
+}
+
+static float thres(int r)
+{
+	if (ulpthres >= 0)
+		return ulpthres;
+	return r == RN ? 1.5 : 3.0;
+}
+
+/* 1: too close to a midpoint (RN), 2: too close to a float (directed) */
+static int hardness(long double ref, int prec)
+{
+	long double eps = scalbnl(1, -(prec - 24 - 4));
+	long double d;
+	float y;
+
+	if (!isfinite(ref))
+		return 0;
+	y = ref;
+	if (!isfinite(y))
+		return 0;
+	d = fabsl(scalbnl(ref - y, -eulpf(y)));
+	if (fabsl(d - 0.5) < eps)
+		return 1;
+	if (d != 0 && d < eps)
+		return 2;
+	return 0;
+}
+
+static int same(float y, float yr)
+{
+	if (isnan(y) || isnan(yr))
+		return isnan(y) && isnan(yr);
+	return y == yr && signbit(y) == signbit(yr);
+}
+
+/* correctly rounded result in mode r and the exact value (as long double) with mpfr */
+static void mpref(struct fun *f, float x, int r, float *yr, long double *ref)
+{
+	struct t t = {.r = r, .x = x};
+	int mode = fegetround();
+
+	fesetround(RN);
+	if (!mcache_get(&t, 0)) {
+		if (!mpsafe)
+			pthread_mutex_lock(&mplock);
+		if (f->mp(&t) == 0)
+			mcache_put(&t, 0);
+		if (!mpsafe)
+			pthread_mutex_unlock(&mplock);
+	}
+	fesetround(mode);
+	*yr = t.y;
+	*ref = isfinite(t.y) ? t.y - scalbnl(t.dy, eulpf(t.y)) : t.y;
+}
+
+static void *worker(void *arg)
+{
+	long double *ref;
+	unsigned char *hard;
+	struct stat s[NR];
+	struct fun *f = curf;
+	uint64_t a, b, i;
+	int r, h;
+	float x, y, yr, yf, e;
+	long double want;
+
+	memset(s, 0, sizeof s);
+	ref = malloc(CHUNK * sizeof *ref);
+	hard = malloc(CHUNK);
+	if (!ref || !hard) {
+		fprintf(stderr, "malloc failed\n");
+		exit(1);
+	}
+	for (;;) {
+		pthread_mutex_lock(&lock);
+		a = next;
+		next = a + CHUNK < hi ? a + CHUNK : hi;
+		b = next;
+		pthread_mutex_unlock(&lock);
+		if (a >= b)
+			break;
+
+		/* reference in RN once for all rounding modes */
+		fesetround(RN);
+		for (i = a; i < b; i++) {
+			ref[i-a] = f->ref(asfloat(i));
+			hard[i-a] = hardness(ref[i-a], f->prec);
+		}
+		for (r = 0; r < NR; r++) {
+			if (!rused[r])
+				continue;
+			fesetround(rmode[r]);
+			h = rmode[r] == RN ? 1 : 2;
+			for (i = a; i < b; i++) {
+				x = asfloat(i);
+				y = f->f(x);
+				yr = want = ref[i-a];
+				if (hard[i-a] == h)
+					s[r].hard++;
+				if (hard[i-a] == h || !same(y, yr)) {
+					yf = yr;
+					mpref(f, x, rmode[r], &yr, &want);
+					if (!same(yr, yf))
+						s[r].badref++;
+				}
+				e = err(y, want, yr);
+				if (isnan(y) && isnan(yr))
+					continue;
+				if (!same(y, yr))
+					s[r].mismatch++;
+				if (e > thres(rmode[r]))
+					s[r].fail++;
+				add(s + r, i, e, y, yr);
+			}
+		}
+	}
+	fesetround(RN);
+	free(ref);
+	free(hard);
+	mpthreadexit();
+	pthread_mutex_lock(&lock);
+	for (r = 0; r < NR; r++)
+		merge(total + r, s + r);
+	pthread_mutex_unlock(&lock);
+	return 0;
+}
+
+/* the worst inputs of the fast reference again with mpfr, sorted again */
+static void recheck(struct fun *f, struct stat *s, int r)
+{
+	struct worst w;
+	long double want;
+	float yr;
+	int i, j;
+
+	for (i = 0; i < s->nworst; i++) {
+		w = s->worst[i];
+		mpref(f, asfloat(w.x), r, &yr, &want);
+		w.want = yr;
+		w.err = err(w.got, want, yr);
+		for (j = i; j > 0 && s->worst[j-1].err < w.err; j--)
+			s->worst[j] = s->worst[j-1];
+		s->worst[j] = w;
+	}
+	if (s->nworst)
+		s->maxerr = s->worst[0].err;
+}
+
+static int run(struct fun *f, int nthread)
+{
+	pthread_t td[256];
+	int i, j, r;
+
+	curf = f;
+	mpsafe = mpthreadsafe(f->name);
+	if (cachedir) {
+		if (!mpname())
+			fprintf(stderr, "mpfr results are not cached\n");
+		else
+			mcache_open(cachedir, f->name, mpname());
+	}
+	next = lo;
+	memset(total, 0, sizeof total);
+	for (i = 0; i < nthread; i++)
+		if ((r = pthread_create(td + i, 0, worker, 0))) {
+			fprintf(stderr, "pthread_create: %s\n", strerror(r));
+			break;
+		}
+	if (i == 0) {
+		mcache_close();
+		return -1;
+	}
+	while (i--)
+		pthread_join(td[i], 0);
+
+	for (r = 0; r < NR; r++) {
+		if (!rused[r])
+			continue;
+		recheck(f, total + r, rmode[r]);
+		printf("# %s %s: maxerr %.3f mismatch %llu fail %llu hard %llu badref %llu\n",
+			f->name, rstr(rmode[r]), total[r].maxerr,
+			(unsigned long long)total[r].mismatch,
+			(unsigned long long)total[r].fail,
+			(unsigned long long)total[r].hard,
+			(unsigned long long)total[r].badref);
+		for (j = 0; j < total[r].nworst; j++)
+			printf("%s %a // %s want %a got %a ulperr %.3f\n",
+				rstr(rmode[r]), asfloat(total[r].worst[j].x), f->name,
+				total[r].worst[j].want, total[r].worst[j].got, total[r].worst[j].err);
+	}
+	mcache_close();
+	fflush(stdout);
+	return 0;
+}
+
+static int setmodes(char *s)
+{
+	char *a[NR+1];
+	int i, j, r, n;
+
+	memset(rused, 0, sizeof rused);
+	n = splitstr(a, NR+1, s, ",");
+	for (i = 0; i < n; i++) {
+		if (rconv(&r, a[i]))
+			return -1;
+		for (j = 0; j < NR; j++)
+			if (rmode[j] == r)
+				rused[j] = 1;
+	}
+	return 0;
+}
+
+static void usage(char *argv0)
+{
+	fprintf(stderr, "usage: %s [-j nthreads] [-r RN,RZ,RD,RU] [-a lo] [-b hi] [-k worst] [-u ulpthres] [-C cachedir] func.. | all\n", argv0);
+	exit(1);
+}
+
+int main(int argc, char *argv[])
+{
+	int nthread, opt, i, j, all;
+	char *e;
+
+	nthread = sysconf(_SC_NPROCESSORS_ONLN);
+	if (nthread < 1)
+		nthread = 1;
+	for (i = 0; i < NR; i++)
+		rused[i] = 1;
+	while ((opt = getopt(argc, argv, "j:r:a:b:k:u:C:")) != -1) {
+		switch (opt) {
+		case 'j':
+			nthread = strtol(optarg, &e, 0);
+			if (*e || nthread < 1 || nthread > 256)
+				usage(argv[0]);
+			break;
+		case 'r':
+			if (setmodes(optarg))
+				usage(argv[0]);
+			break;
+		case 'a':
+			lo = strtoull(optarg, &e, 0);
+			if (*e)
+				usage(argv[0]);
+			break;
+		case 'b':
+			hi = strtoull(optarg, &e, 0);
+			if (*e)
+				usage(argv[0]);
+			break;
+		case 'k':
+			nworst = strtol(optarg, &e, 0);
+			if (*e || nworst < 1 || nworst > MAXK)
+				usage(argv[0]);
+			break;
+		case 'u':
+			ulpthres = strtod(optarg, &e);
+			if (*e)
+				usage(argv[0]);
+			break;
+		case 'C':
+			cachedir = optarg;
+			break;
+		default:
+			usage(argv[0]);
+		}
+	}
+	if (optind >= argc || hi > 1ULL<<32 || lo > hi)
+		usage(argv[0]);
+	for (i = optind; i < argc; i++) {
+		all = strcmp(argv[i], "all") == 0;
+		for (j = 0; j < sizeof fun/sizeof *fun; j++)
+			if (all || strcmp(argv[i], fun[j].name) == 0) {
+				if (run(fun + j, nthread))
+					return 1;
+				if (!all)
+					break;
+			}
+		if (!all && j == sizeof fun/sizeof *fun) {
+			fprintf(stderr, "unknown func: %s\n", argv[i]);
+			return 1;
+		}
+	}
+	return 0;
+}
@@ -2,6 +2,9 @@
 ./gen can generate testcases using an mp lib
 ./check can test an mp lib compared to the input
 
+usage: ./gen [-j nthreads] [-I] [-O] [-C cachedir] func
+       ./check [-j nthreads] [-I] [-O] [-H csvfile] func [ulpthres]
+
 input format:
 T.<rounding>.<inputs>.<outputs>.<outputerr>.<exceptflags>.
 where . is a sequence of separators: " \t,(){}"
@@ -14,6 +17,25 @@ so the following are all ok and equivalent input:
 
 for gen only rounding and inputs are required (the rest is discarded)
 
+with -I the input and with -O the output is binary: native struct t
+records (see gen.h), this saves the text formatting and parsing when
+the tools are piped together on the same machine:
+
+ ./rnd -n 1000000 |./gen -O sin |./check -I sin 1.5
+
+check -O writes the failing input records only (no comments).
+gen -C dir looks up the results in dir/func.cache and adds the newly
+computed ones (see mcache.c), so regenerating vectors does not repeat
+the mpfr evaluations. the libm results of mgen and check are not cached.
+check -H writes ulp error statistics of all inputs as csv (see struct
+ustat), so two libms can be compared per rounding mode and input range.
+
+the input is processed in batches: nthreads threads (default: number
+of cpus) parse and compute the items of a batch in parallel, then the
+results are written in input order, so the output does not depend on
+nthreads. functions whose mp implementation is not thread safe (see
+mpthreadsafe) run in one thread.
+
 gen:
 	s = getline()
 	x = scan(s)
@@ -28,15 +50,23 @@ check:
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <stddef.h>
 #include <string.h>
+#include <stdarg.h>
+#include <unistd.h>
+#include <pthread.h>
 #include "gen.h"
 
+#define BATCH 4096
+#define CHUNK 16
+#define MAXTHREAD 256
+
 static int scan(const char *fmt, struct t *t, char *buf);
 static int print(const char *fmt, struct t *t, char *buf, int n);
 
 // TODO: many output, fmt->ulp
 struct fun;
-static int check(struct t *want, struct t *got, struct fun *f, float ulpthres, float *abserr);
+static int check(struct t *want, struct t *got, struct fun *f, float ulpthres, float *abserr, char *msg, int n);
 
 struct fun {
 	char *name;
@@ -48,97 +78,302 @@ struct fun {
 #undef T
 };
 
-int main(int argc, char *argv[])
-{
-	char buf[512];
-	char *p;
-	int checkmode;
-	int i;
+enum {ESCAN = 1, EMPF = 2, EFMT = 4};
+
+struct item {
+	int line;
+	int skip;
+	int err;
+	int bad;
+	float abserr;
 	struct t t;
 	struct t tread;
-	struct fun *f = 0;
-	double ulpthres = 1.0;
+	char buf[512];
+	char msg[512];
+};
+
+static struct fun *f;
+static int checkmode;
+static int binin, binout;
+static double ulpthres = 1.0;
+static FILE *hfile;
+static int iin;
+
+static struct item *item;
+static int nitem;
+static int next;
+static int quit;
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_barrier_t start, done;
+
+/* parse, compute and format one item, it only touches its own item */
+static void run(struct item *p)
+{
+	if (!binin) {
+		dropcomm(p->buf);
+		if (*p->buf == 0 || *p->buf == '\n') {
+			p->skip = 1;
+			return;
+		}
+		memset(&p->t, 0, sizeof p->t);
+		if (scan(f->fmt, &p->t, p->buf))
+			p->err |= ESCAN;
+	}
+	p->tread = p->t;
+	if (!mcache_get(&p->t, iin)) {
+		if (f->mpf(&p->t))
+			p->err |= EMPF;
+		else
+			mcache_put(&p->t, iin);
+	}
+	if (checkmode) {
+		p->abserr = 0;
+		p->bad = check(&p->tread, &p->t, f, ulpthres, &p->abserr, p->msg, sizeof p->msg);
+		if (p->bad && !binout)
+			print(f->fmt, &p->tread, p->buf, sizeof p->buf);
+	} else if (!binout) {
+		if (print(f->fmt, &p->t, p->buf, sizeof p->buf))
+			p->err |= EFMT;
+	}
+}
+
+static void runbatch(void)
+{
+	int i, j;
+
+	for (;;) {
+		pthread_mutex_lock(&lock);
+		i = next;
+		next += CHUNK;
+		pthread_mutex_unlock(&lock);
+		if (i >= nitem)
+			break;
+		for (j = i; j < i + CHUNK && j < nitem; j++)
+			run(item + j);
+	}
+}
+
+static void *worker(void *arg)
+{
+	for (;;) {
+		pthread_barrier_wait(&start);
+		if (quit)
+			break;
+		runbatch();
+		pthread_barrier_wait(&done);
+	}
+	mpthreadexit();
+	return 0;
+}
+
+static int readbatch(int line)
+{
+	int n;
+
+	for (n = 0; n < BATCH; n++) {
+		memset(item + n, 0, offsetof(struct item, buf));
+		item[n].line = line + n + 1;
+		if (binin) {
+			if (fread(&item[n].t, sizeof item[n].t, 1, stdin) != 1)
+				break;
+		} else if (!fgets(item[n].buf, sizeof item[n].buf, stdin))
+			break;
+	}
+	return n;
+}
+
+static void usage(char *argv0)
+{
+	if (checkmode)
+		fprintf(stderr, "usage: %s [-j nthreads] [-I] [-O] [-H csvfile] func [ulpthres]\n", argv0);
+	else
+		fprintf(stderr, "usage: %s [-j nthreads] [-I] [-O] [-C cachedir] func\n", argv0);
+	exit(1);
+}
+
+int main(int argc, char *argv[])
+{
+	pthread_t td[MAXTHREAD];
+	struct item *p;
+	char *e;
+	int nthread, opt, line, r, i;
 	float maxerr = 0;
-	float abserr;
 	struct t terr;
+	struct ustat *st = 0;
+	char *cachedir = 0;
 
-	p = strrchr(argv[0], '/');
-	if (!p)
-		p = argv[0];
-	else
-		p++;
-	checkmode = strcmp(p, "check") == 0;
-	if (argc < 2) {
-		fprintf(stderr, "%s func%s\n", argv[0], checkmode ? " ulpthres" : "");
-		return 1;
+	e = strrchr(argv[0], '/');
+	checkmode = strcmp(e ? e+1 : argv[0], "check") == 0;
+	nthread = sysconf(_SC_NPROCESSORS_ONLN);
+	while ((opt = getopt(argc, argv, "j:IOH:C:")) != -1) {
+		switch (opt) {
+		case 'j':
+			nthread = strtol(optarg, &e, 0);
+			if (*e || nthread < 1 || nthread > MAXTHREAD)
+				usage(argv[0]);
+			break;
+		case 'I':
+			binin = 1;
+			break;
+		case 'O':
+			binout = 1;
+			break;
+		case 'C':
+			if (checkmode)
+				usage(argv[0]);
+			cachedir = optarg;
+			break;
+		case 'H':
+			if (!checkmode || hfile)
+				usage(argv[0]);
+			hfile = strcmp(optarg, "-") == 0 ? stdout : fopen(optarg, "w");
+			st = calloc(1, sizeof *st);
+			if (!hfile || !st) {
+				fprintf(stderr, "%s: cannot open\n", optarg);
+				return 1;
+			}
+			break;
+		default:
+			usage(argv[0]);
+		}
 	}
-	if (argc > 2 && checkmode) {
-		ulpthres = strtod(argv[2], &p);
-		if (*p) {
-			fprintf(stderr, "invalid ulperr %s\n", argv[2]);
+	if (nthread < 1)
+		nthread = 1;
+	if (nthread > MAXTHREAD)
+		nthread = MAXTHREAD;
+	if (optind >= argc || optind + 1 + checkmode < argc)
+		usage(argv[0]);
+	if (optind + 1 < argc) {
+		ulpthres = strtod(argv[optind+1], &e);
+		if (*e) {
+			fprintf(stderr, "invalid ulperr %s\n", argv[optind+1]);
 			return 1;
 		}
 	}
 	for (i = 0; i < sizeof fun/sizeof *fun; i++)
-		if (strcmp(fun[i].name, argv[1]) == 0) {
+		if (strcmp(fun[i].name, argv[optind]) == 0) {
 			f = fun + i;
 			break;
 		}
 	if (f == 0) {
-		fprintf(stderr, "unknown func: %s\n", argv[1]);
+		fprintf(stderr, "unknown func: %s\n", argv[optind]);
 		return 1;
 	}
-	for (i = 1; fgets(buf, sizeof buf, stdin); i++) {
-		dropcomm(buf);
-		if (*buf == 0 || *buf == '\n')
-			continue;
-		memset(&t, 0, sizeof t);
-		if (scan(f->fmt, &t, buf))
-			fprintf(stderr, "error scan %s, line %d\n", f->name, i);
-		tread = t;
-		if (f->mpf(&t))
-			fprintf(stderr, "error mpf %s, line %d\n", f->name, i);
-		if (checkmode) {
-			if (check(&tread, &t, f, ulpthres, &abserr)) {
-				print(f->fmt, &tread, buf, sizeof buf);
-				fputs(buf, stdout);
-//				print(f->fmt, &t, buf, sizeof buf);
-//				fputs(buf, stdout);
-			}
-			if (abserr > maxerr) {
-				maxerr = abserr;
-				terr = tread;
-			}
-		} else {
-			if (print(f->fmt, &t, buf, sizeof buf))
-				fprintf(stderr, "error fmt %s, line %d\n", f->name, i);
-			fputs(buf, stdout);
+	if (!mpthreadsafe(f->name))
+		nthread = 1;
+	/* whether the int is an input (jn) or an output (lgamma_r) */
+	e = strchr(f->fmt, '_');
+	iin = e && memchr(f->fmt, 'i', e - f->fmt);
+	if (cachedir) {
+		if (!mpname())
+			fprintf(stderr, "%s results are not cached\n", argv[0]);
+		else
+			mcache_open(cachedir, f->name, mpname());
+	}
+	item = malloc(BATCH * sizeof *item);
+	if (!item) {
+		fprintf(stderr, "malloc failed\n");
+		return 1;
+	}
+
+	/* the main thread is one of the nthread workers */
+	pthread_barrier_init(&start, 0, nthread);
+	pthread_barrier_init(&done, 0, nthread);
+	for (i = 1; i < nthread; i++)
+		if ((r = pthread_create(td + i, 0, worker, 0))) {
+			fprintf(stderr, "pthread_create: %s\n", strerror(r));
+			return 1;
+		}
+
+	for (line = 0; (nitem = readbatch(line)) > 0; line += nitem) {
+		next = 0;
+		pthread_barrier_wait(&start);
+		runbatch();
+		pthread_barrier_wait(&done);
+
+		for (p = item; p < item + nitem; p++) {
+			if (p->skip)
+				continue;
+			if (p->err & ESCAN)
+				fprintf(stderr, "error scan %s, line %d\n", f->name, p->line);
+			if (p->err & EMPF)
+				fprintf(stderr, "error mpf %s, line %d\n", f->name, p->line);
+			if (p->err & EFMT)
+				fprintf(stderr, "error fmt %s, line %d\n", f->name, p->line);
+			if (checkmode) {
+				if (p->bad) {
+					if (binout)
+						fwrite(&p->tread, sizeof p->tread, 1, stdout);
+					else {
+						fputs(p->msg, stdout);
+						fputs(p->buf, stdout);
+					}
+				}
+				if (p->abserr > maxerr) {
+					maxerr = p->abserr;
+					terr = p->tread;
+				}
+				/* abserr is only set when the result is not exact */
+				ustat_add(st, p->tread.r, p->tread.x, p->abserr ? p->abserr : p->tread.dy);
+			} else if (binout)
+				fwrite(&p->t, sizeof p->t, 1, stdout);
+			else
+				fputs(p->buf, stdout);
 		}
 	}
-	if (checkmode && maxerr) {
+
+	quit = 1;
+	pthread_barrier_wait(&start);
+	for (i = 1; i < nthread; i++)
+		pthread_join(td[i], 0);
+	mcache_close();
+	if (checkmode && maxerr && !binout) {
+		char buf[512];
+
 		printf("// maxerr: %f, ", maxerr);
 		print(f->fmt, &terr, buf, sizeof buf);
 		fputs(buf, stdout);
 	}
+	if (hfile) {
+		ustat_csvhead(hfile);
+		ustat_csv(hfile, f->name, st);
+		if (fflush(hfile)) {
+			fprintf(stderr, "writing statistics failed\n");
+			return 1;
+		}
+	}
 	return 0;
 }
 
-static int check(struct t *want, struct t *got, struct fun *f, float ulpthres, float *abserr)
+/* append to the n byte buffer msg */
+static void add(char *msg, int n, const char *fmt, ...)
+{
+	va_list ap;
+	int k = strlen(msg);
+
+	va_start(ap, fmt);
+	if (k < n)
+		vsnprintf(msg + k, n - k, fmt, ap);
+	va_end(ap);
+}
+
+static int check(struct t *want, struct t *got, struct fun *f, float ulpthres, float *abserr, char *msg, int n)
 {
 	int err = 0;
 	int m = INEXACT|UNDERFLOW; // TODO: dont check inexact and underflow for now
 
+	*msg = 0;
 	if ((got->e|m) != (want->e|m)) {
-		fprintf(stdout, "//%s %s(%La,%La)==%La except: want %s",
+		add(msg, n, "//%s %s(%La,%La)==%La except: want %s",
 			rstr(want->r), f->name, want->x, want->x2, want->y, estr(want->e));
-		fprintf(stdout, " got %s\n", estr(got->e));
+		add(msg, n, " got %s\n", estr(got->e));
 		err++;
 	}
 	if (isnan(got->y) && isnan(want->y))
 		return err;
 	if (got->y != want->y || signbit(got->y) != signbit(want->y)) {
 		char *p;
-		int n;
+		int k;
 		float d;
 
 		p = strchr(f->fmt, '_');
@@ -146,19 +381,19 @@ static int check(struct t *want, struct t *got, struct fun *f, float ulpthres, f
 			return -1;
 		p++;
 		if (*p == 'd')
-			n = eulp(want->y);
+			k = eulp(want->y);
 		else if (*p == 'f')
-			n = eulpf(want->y);
+			k = eulpf(want->y);
 		else if (*p == 'l')
-			n = eulpl(want->y);
+			k = eulpl(want->y);
 		else
 			return -1;
 
-		d = scalbnl(got->y - want->y, -n);
+		d = scalbnl(got->y - want->y, -k);
 		*abserr = fabsf(d + want->dy);
 		if (*abserr <= ulpthres)
 			return err;
-		fprintf(stdout, "//%s %s(%La,%La) want %La got %La ulperr %.3f = %a + %a\n",
+		add(msg, n, "//%s %s(%La,%La) want %La got %La ulperr %.3f = %a + %a\n",
 			rstr(want->r), f->name, want->x, want->x2, want->y, got->y, d + want->dy, d, want->dy);
 		err++;
 	}
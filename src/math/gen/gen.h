@@ -1,3 +1,4 @@
+#include <stdio.h>
 #include <fenv.h>
 #include <math.h>
 #include <float.h>
@@ -58,6 +59,22 @@ double ulperr(double y, double ycr, double dy);
 void setupfenv(int);
 int getexcept(void);
 
+/* ulp error statistics, shared with the math tests */
+#include "../../common/ustat.h"
+
+/* persistent cache of mp results, see mcache.c */
+int mcache_open(const char *dir, const char *func, const char *backend);
+void mcache_close(void);
+int mcache_get(struct t *, int iin);
+void mcache_put(const struct t *, int iin);
+
+/* name and version of the mp implementation for the cache, 0 if its results must not be cached */
+const char *mpname(void);
+/* 0 if the mp implementation of func cannot run in parallel threads */
+int mpthreadsafe(const char *func);
+/* frees the per thread state of the mp lib, called by exiting threads */
+void mpthreadexit(void);
+
 #define T(f,x) int mp##f(struct t *);
 #include "functions.h"
 #undef T
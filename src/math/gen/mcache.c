@@ -0,0 +1,283 @@
+/*
+persistent cache of mp results
+
+dir/func.cache is an append only file of fixed size records, each
+record holds the key (rounding mode and the bit patterns of the inputs)
+the results and a checksum, the file starts with a header naming the mp
+backend and the long double format, a cache made by another backend is
+not used. on open the records are indexed by the hash of the key, new
+results are appended with single O_APPEND writes so several processes
+can share the cache, a torn record at the end is cut off.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <float.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include "gen.h"
+
+static const char magic[8] = "mcache1";
+
+struct hdr {
+	char magic[8];
+	char backend[48];
+	int32_t mant;
+	int32_t recsize;
+	char pad[64];
+};
+
+/* no implicit padding so the bytes of a record are well defined */
+struct key {
+	int32_t r;
+	int32_t iin;
+	int64_t i;
+	unsigned char x[3][16];
+};
+
+struct val {
+	unsigned char y[2][16];
+	float dy;
+	float dy2;
+	int32_t e;
+	int32_t pad;
+	int64_t i;
+};
+
+struct rec {
+	uint64_t sum;
+	struct key k;
+	struct val v;
+};
+
+static struct {
+	int fd;
+	struct rec *rec;
+	size_t n, cap;
+	uint32_t *tab;
+	size_t tablen;
+} c = {-1};
+
+static pthread_rwlock_t lock = PTHREAD_RWLOCK_INITIALIZER;
+
+static uint64_t fnv(uint64_t h, const void *p, size_t n)
+{
+	const unsigned char *s = p;
+
+	while (n--)
+		h = (h ^ *s++) * 0x100000001b3ULL;
+	return h;
+}
+
+static uint64_t keyhash(const struct key *k)
+{
+	return fnv(0xcbf29ce484222325ULL, k, sizeof *k);
+}
+
+static uint64_t recsum(const struct rec *r)
+{
+	return fnv(keyhash(&r->k), &r->v, sizeof r->v);
+}
+
+/* only the significant bytes of a long double, the rest is padding */
+static void ldbits(unsigned char *p, long double x)
+{
+	memset(p, 0, 16);
+#if LDBL_MANT_DIG == 64
+	memcpy(p, &x, 10);
+#else
+	memcpy(p, &x, sizeof x < 16 ? sizeof x : 16);
+#endif
+}
+
+static long double ldval(const unsigned char *p)
+{
+	long double x = 0;
+
+#if LDBL_MANT_DIG == 64
+	memcpy(&x, p, 10);
+#else
+	memcpy(&x, p, sizeof x < 16 ? sizeof x : 16);
+#endif
+	return x;
+}
+
+static void mkkey(struct key *k, const struct t *t, int iin)
+{
+	memset(k, 0, sizeof *k);
+	k->r = t->r;
+	k->iin = iin;
+	if (iin)
+		k->i = t->i;
+	ldbits(k->x[0], t->x);
+	ldbits(k->x[1], t->x2);
+	ldbits(k->x[2], t->x3);
+}
+
+/* index of the slot of k in tab */
+static size_t slot(const struct key *k)
+{
+	size_t i = keyhash(k) & (c.tablen-1);
+	size_t j = 1;
+
+	while (c.tab[i] && memcmp(&c.rec[c.tab[i]-1].k, k, sizeof *k)) {
+		i += j++;
+		i &= c.tablen-1;
+	}
+	return i;
+}
+
+static int add(const struct rec *r)
+{
+	size_t i;
+
+	if (c.n == c.cap) {
+		size_t cap = c.cap ? 2*c.cap : 4096;
+		struct rec *p = realloc(c.rec, cap * sizeof *p);
+		if (!p)
+			return -1;
+		c.rec = p;
+		c.cap = cap;
+	}
+	if (2*(c.n+1) > c.tablen) {
+		size_t len = c.tablen ? 2*c.tablen : 8192;
+		uint32_t *p = calloc(len, sizeof *p);
+		if (!p)
+			return -1;
+		free(c.tab);
+		c.tab = p;
+		c.tablen = len;
+		for (i = 0; i < c.n; i++)
+			c.tab[slot(&c.rec[i].k)] = i+1;
+	}
+	i = slot(&r->k);
+	if (c.tab[i])
+		return 0;
+	c.rec[c.n] = *r;
+	c.tab[i] = ++c.n;
+	return 0;
+}
+
+static int load(const char *file, const char *backend)
+{
+	struct hdr h, want;
+	struct rec r;
+	off_t off;
+
+	memset(&want, 0, sizeof want);
+	memcpy(want.magic, magic, sizeof want.magic);
+	snprintf(want.backend, sizeof want.backend, "%s", backend);
+	want.mant = LDBL_MANT_DIG;
+	want.recsize = sizeof r;
+
+	flock(c.fd, LOCK_EX);
+	if (read(c.fd, &h, sizeof h) != sizeof h) {
+		/* new cache */
+		if (ftruncate(c.fd, 0) || write(c.fd, &want, sizeof want) != sizeof want)
+			goto fail;
+	} else if (memcmp(&h, &want, sizeof h)) {
+		fprintf(stderr, "%s: made by %.48s, not by %s\n", file, h.backend, backend);
+		goto fail;
+	} else {
+		for (off = sizeof h; read(c.fd, &r, sizeof r) == sizeof r; off += sizeof r) {
+			if (r.sum != recsum(&r))
+				break;
+			if (add(&r))
+				goto fail;
+		}
+		if (ftruncate(c.fd, off))
+			goto fail;
+	}
+	flock(c.fd, LOCK_UN);
+	return 0;
+fail:
+	flock(c.fd, LOCK_UN);
+	return -1;
+}
+
+int mcache_open(const char *dir, const char *func, const char *backend)
+{
+	char file[4096];
+
+	if (snprintf(file, sizeof file, "%s/%s.cache", dir, func) >= sizeof file) {
+		fprintf(stderr, "%s: path too long\n", dir);
+		return -1;
+	}
+	c.fd = open(file, O_RDWR|O_CREAT|O_APPEND, 0644);
+	if (c.fd < 0) {
+		fprintf(stderr, "%s: %s\n", file, strerror(errno));
+		return -1;
+	}
+	if (load(file, backend)) {
+		fprintf(stderr, "%s: cache not used\n", file);
+		mcache_close();
+		return -1;
+	}
+	return 0;
+}
+
+void mcache_close(void)
+{
+	if (c.fd >= 0)
+		close(c.fd);
+	free(c.rec);
+	free(c.tab);
+	memset(&c, 0, sizeof c);
+	c.fd = -1;
+}
+
+/* 1 if the results of t are found, iin is set when t->i is an input */
+int mcache_get(struct t *t, int iin)
+{
+	struct key k;
+	struct rec *r = 0;
+	size_t i;
+
+	if (c.fd < 0)
+		return 0;
+	mkkey(&k, t, iin);
+	pthread_rwlock_rdlock(&lock);
+	if (c.tablen && c.tab[i = slot(&k)])
+		r = c.rec + c.tab[i] - 1;
+	if (r) {
+		t->y = ldval(r->v.y[0]);
+		t->y2 = ldval(r->v.y[1]);
+		t->dy = r->v.dy;
+		t->dy2 = r->v.dy2;
+		t->e = r->v.e;
+		if (!iin)
+			t->i = r->v.i;
+	}
+	pthread_rwlock_unlock(&lock);
+	return r != 0;
+}
+
+void mcache_put(const struct t *t, int iin)
+{
+	struct rec r;
+
+	if (c.fd < 0)
+		return;
+	memset(&r, 0, sizeof r);
+	mkkey(&r.k, t, iin);
+	ldbits(r.v.y[0], t->y);
+	ldbits(r.v.y[1], t->y2);
+	r.v.dy = t->dy;
+	r.v.dy2 = t->dy2;
+	r.v.e = t->e;
+	r.v.i = iin ? 0 : t->i;
+	r.sum = recsum(&r);
+	pthread_rwlock_wrlock(&lock);
+	if (!c.tablen || !c.tab[slot(&r.k)]) {
+		if (write(c.fd, &r, sizeof r) != sizeof r)
+			fprintf(stderr, "mcache write failed: %s\n", strerror(errno));
+		add(&r);
+	}
+	pthread_rwlock_unlock(&lock);
+}
@@ -26,6 +26,25 @@ static const int emax[] = {
 [LDBL] = 16384
 };
 
+/* the flags and exponent range are per thread only in a thread safe mpfr */
+int mpthreadsafe(const char *func)
+{
+	return mpfr_buildopt_tls_p();
+}
+
+void mpthreadexit(void)
+{
+	mpfr_free_cache();
+}
+
+const char *mpname(void)
+{
+	static char buf[48];
+
+	snprintf(buf, sizeof buf, "mpfr %s", mpfr_get_version());
+	return buf;
+}
+
 void debug(mpfr_t x)
 {
 	mpfr_out_str(stdout, 10, 0, x, MPFR_RNDN);
@@ -292,17 +311,17 @@ static int mpl2(struct t *p, int (*fmp)(mpfr_t, const mpfr_t, const mpfr_t, mpfr
 }
 
 // TODO
-static int mplgamma_sign;
+static __thread int mplgamma_sign;
 static int wrap_lgamma(mpfr_t my, const mpfr_t mx, mpfr_rnd_t r)
 {
 	return mpfr_lgamma(my, &mplgamma_sign, mx, r);
 }
-static long mpremquo_q;
+static __thread long mpremquo_q;
 static int wrap_remquo(mpfr_t my, const mpfr_t mx, const mpfr_t mx2, mpfr_rnd_t r)
 {
 	return mpfr_remquo(my, &mpremquo_q, mx, mx2, r);
 }
-static int mpbessel_n;
+static __thread int mpbessel_n;
 static int wrap_jn(mpfr_t my, const mpfr_t mx, mpfr_rnd_t r)
 {
 	return mpfr_jn(my, mpbessel_n, mx, r);
@@ -1,6 +1,8 @@
 #include <stdint.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
+#include <math.h>
 #include <errno.h>
 #include <unistd.h>
 
@@ -229,6 +231,127 @@ int genab(size_t k, uint64_t a, uint64_t b, uint64_t *p)
 
 #define asfloat(x) ((union{uint64_t af_i; double af_f;}){.af_i=x}.af_f)
 #define asint(x)   ((union{uint64_t af_i; double af_f;}){.af_f=x}.af_i)
+#define asfloatf(x) ((union{uint32_t af_i; float af_f;}){.af_i=x}.af_f)
+#define asintf(x)   ((union{uint32_t af_i; float af_f;}){.af_f=x}.af_i)
+
+/*
+guided search: the "//RN f(x,..) want .. ulperr e" lines of check are
+read from stdin, the k worst inputs are printed and n new inputs are
+generated around them: a parent is picked with bias towards the worse
+ones and moved by a random number of ulps with log uniform scale, so
+both nearby and distant neighbours are tried. only the first argument
+is kept, the rounding mode is kept.
+*/
+#define MAXK 1024
+
+static struct worst {
+	char r[3];
+	double x;
+	float err;
+} worst[MAXK];
+static int nworst;
+
+static int cmpworst(const void *a, const void *b)
+{
+	const struct worst *wa = a, *wb = b;
+	return wa->err > wb->err ? -1 : wa->err < wb->err;
+}
+
+static void addworst(int k, char *r, double x, float err)
+{
+	int i;
+
+	for (i = 0; i < nworst; i++)
+		if (worst[i].x == x && strcmp(worst[i].r, r) == 0) {
+			if (err > worst[i].err)
+				worst[i].err = err;
+			return;
+		}
+	if (nworst == k) {
+		/* worst is sorted when full */
+		if (err <= worst[k-1].err)
+			return;
+		nworst--;
+	}
+	memcpy(worst[nworst].r, r, 2);
+	worst[nworst].x = x;
+	worst[nworst].err = err;
+	nworst++;
+	if (nworst == k)
+		qsort(worst, nworst, sizeof *worst, cmpworst);
+}
+
+static int readworst(int k)
+{
+	char buf[1024];
+	char *p, *q;
+	float err;
+	double x;
+
+	while (fgets(buf, sizeof buf, stdin)) {
+		if (strncmp(buf, "//R", 3) != 0 || !(p = strstr(buf, " ulperr ")))
+			continue;
+		if (!(q = strchr(buf, '(')))
+			continue;
+		x = strtod(q+1, &q);
+		if (*q != ',' && *q != ')')
+			continue;
+		err = fabs(strtod(p+8, 0));
+		buf[4] = 0;
+		addworst(k, buf+2, x, err);
+	}
+	qsort(worst, nworst, sizeof *worst, cmpworst);
+	return nworst;
+}
+
+/* move x by 1 .. 2^bits ulps towards or away from 0 */
+static double mutate(double x, int isfloat)
+{
+	int j = 1 + randn(isfloat ? 23 : 52);
+	uint64_t d = 1 + (rand64() >> (64 - j));
+	uint64_t m, s, top;
+
+	if (isfloat) {
+		m = asintf((float)x);
+		s = m & 0x80000000;
+		m &= 0x7fffffff;
+		top = 0x7f800000;
+	} else {
+		m = asint(x);
+		s = m & 1ULL<<63;
+		m &= -1ULL>>1;
+		top = 0x7ffULL<<52;
+	}
+	if (rand32() & 1)
+		m = m > d ? m - d : 0;
+	else
+		m = m + d < top ? m + d : top - 1;
+	if (isfloat)
+		return asfloatf(s | m);
+	return asfloat(s | m);
+}
+
+static int guided(int k, uint64_t n, int isfloat)
+{
+	uint64_t i;
+	int j, r;
+
+	if (!readworst(k)) {
+		fprintf(stderr, "no ulperr lines in the input\n");
+		return -1;
+	}
+	for (j = 0; j < nworst; j++)
+		printf("%s %a // ulperr %.3f\n", worst[j].r, worst[j].x, worst[j].err);
+	for (i = 0; i < n; i++) {
+		/* the lower of two ranks, biased towards the worst inputs */
+		j = randn(nworst);
+		r = randn(nworst);
+		if (r < j)
+			j = r;
+		printf("%s %a\n", worst[j].r, mutate(worst[j].x, isfloat));
+	}
+	return 0;
+}
 
 int main(int argc, char *argv[])
 {
@@ -236,13 +359,13 @@ int main(int argc, char *argv[])
 	uint64_t *p;
 	double a,b,m;
 	char *e;
-	int opt;
+	int opt, g = 0, isfloat = 0;
 
 	k = 1000;
 	a = 0;
 	b = 1;
 	m = 1;
-	while ((opt = getopt(argc, argv, "n:a:b:m:s:")) != -1) {
+	while ((opt = getopt(argc, argv, "n:a:b:m:s:g:f")) != -1) {
 		switch(opt) {
 		case 'n':
 			k = strtoull(optarg,&e,0);
@@ -263,14 +386,26 @@ int main(int argc, char *argv[])
 		case 's':
 			seed = strtoull(optarg,&e,0);
 			break;
+		case 'g':
+			g = strtol(optarg,&e,0);
+			if (g < 1 || g > MAXK)
+				goto usage;
+			break;
+		case 'f':
+			isfloat = 1;
+			e = "";
+			break;
 		default:
 usage:
 			fprintf(stderr, "usage: %s -n num -a absmin -b absmax -m mult -s seed\n", argv[0]);
+			fprintf(stderr, "       %s -g worst [-f] -n num -s seed <checkoutput\n", argv[0]);
 			return -1;
 		}
 		if (*e || errno)
 			goto usage;
 	}
+	if (g)
+		return guided(g, k, isfloat);
 	if (!(a <= b))
 		goto usage;
 	p = malloc(k * sizeof *p);
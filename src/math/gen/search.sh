@@ -0,0 +1,48 @@
+#!/bin/sh
+# guided worst case search for single argument functions:
+# sample uniformly with rnd, then in each round check the samples and
+# resample around the k worst inputs (rnd -g), the k worst inputs of
+# the last round are printed (valid gen input with ulperr comments).
+# the reference is ./gen (mpfr), GEN=./mgen uses libm instead.
+#
+# usage: ./search.sh [-r rounds] [-k worst] [-n num] func [rnd options]
+# e.g.   ./search.sh -r 20 -k 8 tgammaf -a 0x1p-10 -b 40
+
+GEN=${GEN:-./gen}
+R=10
+K=16
+N=10000
+while getopts r:k:n: o
+do
+	case $o in
+	r) R=$OPTARG ;;
+	k) K=$OPTARG ;;
+	n) N=$OPTARG ;;
+	*) exit 1 ;;
+	esac
+done
+shift $((OPTIND-1))
+F=$1
+[ "$F" ] || { echo "usage: $0 [-r rounds] [-k worst] [-n num] func [rnd options]" >&2; exit 1; }
+shift
+
+T=`sed -n "s/^T($F, *\([a-z_]*\))/\1/p" functions.h`
+case $T in
+f_*) FL=-f ;;
+d_*|l_*) FL= ;;
+*) echo "$F: not a single argument function ($T)" >&2; exit 1 ;;
+esac
+
+D=`mktemp -d` || exit 1
+trap 'rm -rf $D' EXIT
+
+./rnd -n $N "$@" >$D/in || exit 1
+i=0
+while [ $i -lt $R ]
+do
+	$GEN $F <$D/in |./check $F 0 >$D/out
+	i=$((i+1))
+	./rnd -g $K $FL -s $i -n $N <$D/out >$D/in || exit 1
+	echo "# round $i: `head -1 $D/in`" >&2
+done
+./rnd -g $K -n 0 <$D/out
@@ -172,4 +172,3 @@ int getexcept(void)
 {
 	return fetestexcept(INEXACT|INVALID|DIVBYZERO|UNDERFLOW|OVERFLOW);
 }
-
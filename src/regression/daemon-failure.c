@@ -11,6 +11,7 @@
 #include <sys/wait.h>
 #include <fcntl.h>
 #include <unistd.h>
+#include <sys/syscall.h>
 #include "test.h"
 
 int daemon(int, int);
@@ -37,8 +38,15 @@ int main(void)
 	}
 
 	if (r == 0) {
-		/* exhausting all fds makes open("/dev/null") fail in daemon */
-		t_fdfill();
+		/* make open("/dev/null") fail in daemon, exhaust all fds
+		if the failure cannot be injected */
+		r = t_sysfail(SYS_openat, 0, EMFILE, 0);
+#ifdef SYS_open
+		if (r == 0)
+			r = t_sysfail(SYS_open, 0, EMFILE, 0);
+#endif
+		if (r < 0)
+			t_fdfill();
 		pid = getpid();
 		errno = 0;
 		r = daemon(0, 0);
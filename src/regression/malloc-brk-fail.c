@@ -16,8 +16,11 @@ int main(void)
 	size_t n;
 	int r;
 
-	// fill memory, largest mmaped area is [p,p+n)
-	if (t_vmfill(&p, &n, 1) < 1 || n < 2*65536) {
+	if (t_allocfail(0, T_AFALL) == 0) {
+		// all mmap and brk calls fail, use up the reserves
+		while (malloc(1));
+	} else if (t_vmfill(&p, &n, 1) < 1 || n < 2*65536) {
+		// fill memory, largest mmaped area is [p,p+n)
 		t_error("vmfill failed\n");
 		return 1;
 	}
@@ -31,7 +34,8 @@ int main(void)
 		t_error("malloc did not fail with ENOMEM, got %s\n", strerror(errno));
 
 	// make space available for mmap, but ensure it's not contiguous with brk
-	T(munmap((char*)p+65536, n-65536));
+	if (t_allocfail(0, T_AFBRK) < 0)
+		T(munmap((char*)p+65536, n-65536));
 
 	// malloc should succeed now
 	q = malloc(10000);
@@ -1,17 +1,38 @@
 // commit: 2e6239dd064d201c6e1b0f589bae9ff27949d2eb 2011-02-19
 // commit: 382584724308442f03f3d29f7fc6de9e9d140982 2011-06-12
 // mkstemp should return -1 on bad template
+// and report the error of a failing syscall
 #define _DEFAULT_SOURCE 1
 #define _BSD_SOURCE 1
 #include <stdlib.h>
 #include <string.h>
 #include <errno.h>
+#include <unistd.h>
 #include "test.h"
 
 int mkstemp(char *);
 
 #define S "/dev/null/fooXXXX"
 
+static int create(void *arg)
+{
+	char p[] = "/tmp/mkstemp-failure-XXXXXX";
+	int r, e;
+
+	r = mkstemp(p);
+	e = errno;
+	/* the cleanup is not part of the sweep */
+	t_sysfail(-1, 0, 0, 0);
+	if (r != -1) {
+		unlink(p);
+		close(r);
+	} else if (e != EIO) {
+		t_error("mkstemp failed with %d [%s] instead of the injected %d [%s]\n",
+			e, strerror(e), EIO, strerror(EIO));
+	}
+	return 0;
+}
+
 int main(void)
 {
 	char p[] = S;
@@ -25,5 +46,9 @@ int main(void)
 	if (r == -1 && errno != EINVAL)
 		t_error("mkstemp(" S ") failed with %d [%s] instead of %d [%s]\n",
 			errno, strerror(errno), EINVAL, strerror(EINVAL));
+
+	// fail each syscall of mkstemp in turn
+	if (t_syssweep(create, 0, EIO) < 0)
+		t_error("syssweep failed: %s\n", strerror(errno));
 	return t_status;
 }
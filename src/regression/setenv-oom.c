@@ -6,16 +6,34 @@
 #include <errno.h>
 #include "test.h"
 
+static int set(void *buf)
+{
+	char *s;
+
+	errno = 0;
+	if (setenv("TESTVAR", buf, 1) == 0) {
+		s = getenv("TESTVAR");
+		if (!s || strcmp(s, buf) != 0)
+			t_error("setenv succeeded but getenv returned %s\n", s ? "other value" : "null");
+	} else if (errno != ENOMEM)
+		t_error("expected ENOMEM, got %s\n", strerror(errno));
+	return 0;
+}
+
 int main(void)
 {
 	char buf[10000];
 
-	if (t_memfill() < 0)
-		t_error("memfill failed\n");
-
 	memset(buf, 'x', sizeof buf);
 	buf[sizeof buf - 1] = 0;
 
+	// fail each malloc of setenv in turn (setenv-oom.mk links the replacement malloc)
+	if (t_allocsweep(set, buf, T_AFMALLOC|T_AFONCE) < 0)
+		t_error("allocsweep failed: %s\n", strerror(errno));
+
+	if (t_memfill() < 0)
+		t_error("memfill failed\n");
+
 	errno = 0;
 	if (setenv("TESTVAR", buf, 1) != -1)
 		t_error("setenv was successful\n");
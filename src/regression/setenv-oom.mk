@@ -0,0 +1,2 @@
+$(N).OBJS := $(B)/common/alloccount.o
+$(N)-static.OBJS := $(B)/common/alloccount.o